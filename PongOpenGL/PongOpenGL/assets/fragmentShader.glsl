@@ -3,10 +3,31 @@
 //#endif
 
 #version 330 core
+in vec4 vertColor;
+in vec2 local;
+flat in vec2 halfSize;
+flat in float radius;
 out vec4 color;
 
 void main() {
-	color = vec4(1.0f);
+#if defined(SDF_EDGES) || defined(SHOW_DISTANCE)
+	//signed distance to a box with rounded corners, a circle when radius is half the size
+	vec2 q = abs(local) - halfSize + radius;
+	float d = length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - radius;
+	float pixels = d / max(fwidth(d), 1e-5);
+#endif
+
+#if defined(SHOW_DISTANCE)
+	//blue inside, orange outside, a band every 4 pixels
+	vec3 tint = d < 0.0 ? vec3(0.2, 0.5, 1.0) : vec3(1.0, 0.5, 0.2);
+	color = vec4(tint * (0.6 + 0.4 * cos(pixels * 1.5708)), 1.0);
+#elif defined(SDF_EDGES)
+	//one pixel wide edge at any scale
+	float coverage = clamp(0.5 - pixels, 0.0, 1.0);
+	color = vec4(vertColor.rgb, vertColor.a * coverage);
+#else
+	color = vertColor;
+#endif
 }
 
 //#ifdef CPP_GLSL_INCLUDE
@@ -5,11 +5,36 @@ std::string vert_string = R"(
 layout (location = 0) in vec2 pos;
 layout (location = 1) in vec2 offset;
 layout (location = 2) in vec2 size;
+layout (location = 3) in vec4 color;
+layout (location = 4) in float corner;
 
-uniform mat4 projection;
+layout (std140) uniform View {
+	mat4 projection;
+	vec4 viewport;
+};
+
+//features come in as #defines right after #version, see ShaderVariants
+//SDF_EDGES: antialiased rounded box cut from the quad by the corner attribute
+//SHOW_DISTANCE: colour by distance to the edge instead of drawing the shape
+
+out vec4 vertColor;
+out vec2 local;
+flat out vec2 halfSize;
+flat out float radius;
 
 void main() {
-	gl_Position = projection * vec4((pos * size) + offset, 0.0, 1.0);
+#if defined(SDF_EDGES) || defined(SHOW_DISTANCE)
+	//grow the shape by a pixel each side so the antialiased edge isn't clipped
+	float pad = 2.0 / (projection[0][0] * viewport.z);
+	local = pos * (size + 2.0 * pad);
+#else
+	local = pos * size;
+#endif
+	halfSize = 0.5 * size;
+	radius = min(corner, min(halfSize.x, halfSize.y));
+
+	gl_Position = projection * vec4(local + offset, 0.0, 1.0);
+	vertColor = color;
 }
 
 )";
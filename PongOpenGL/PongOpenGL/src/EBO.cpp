@@ -1,19 +1,21 @@
 #include "EBO.hpp"
 
 EBO::EBO(GLuint* data, GLsizeiptr numElements, GLenum usage) {
-	glGenBuffers(1, &eboObj);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, eboObj);
+	GLuint name;
+	glGenBuffers(1, &name);
+	eboObj.reset(name);
+	glStateBindBuffer(GL_ELEMENT_ARRAY_BUFFER, eboObj);
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, numElements, data, usage);
 }
 
-void EBO::Bind() {
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, eboObj);
+void EBO::Bind() const {
+	glStateBindBuffer(GL_ELEMENT_ARRAY_BUFFER, eboObj);
 }
 
-void EBO::Unbind() {
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+void EBO::Unbind() const {
+	glStateBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
 
 void EBO::Delete() {
-	glDeleteBuffers(1, &eboObj);
+	eboObj.reset();
 }
\ No newline at end of file
@@ -2,14 +2,16 @@
 #define EBO_H
 
 #include <glad/glad.h>
+#include "glHandle.hpp"
+#include "glState.hpp"
 
 class EBO {
 	public:
-		GLuint eboObj;
+		BufferHandle eboObj;
 		EBO(GLuint* data, GLsizeiptr numElements, GLenum usage);
 
-		void Bind();
-		void Unbind();
+		void Bind() const;
+		void Unbind() const;
 		void Delete();
 };
 
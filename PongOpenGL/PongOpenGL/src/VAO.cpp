@@ -1,11 +1,13 @@
 #include "VAO.hpp"
 
 VAO::VAO() {
-	glGenVertexArrays(1, &vaoObj);
+	GLuint name;
+	glGenVertexArrays(1, &name);
+	vaoObj.reset(name);
 }
 
 //Vbo, which attribute in the shader is being linked (0, 1, 2, etc), number of components for each vertex (vec2, vec3, etc), what variable type, length of the chunks (MULTIPLY BY SIZEOF(VARIABLE)), where to start, how many of the objects will each be used on at a time (good for copying attributes to multiple instanced objects)
-void VAO::LinkAttri(VBO VBO, GLuint layout, GLuint numComponents, GLenum type, GLsizeiptr stride, void* offset, GLuint divisor) {
+void VAO::LinkAttri(const VBO& VBO, GLuint layout, GLuint numComponents, GLenum type, GLsizeiptr stride, void* offset, GLuint divisor) {
 	VBO.Bind();
 	glVertexAttribPointer(layout, numComponents, type, GL_FALSE, stride, offset);
 	glEnableVertexAttribArray(layout);
@@ -16,14 +18,14 @@ void VAO::LinkAttri(VBO VBO, GLuint layout, GLuint numComponents, GLenum type, G
 	VBO.Unbind();
 }
 
-void VAO::Bind() {
-	glBindVertexArray(vaoObj);
+void VAO::Bind() const {
+	glStateBindVertexArray(vaoObj);
 }
 
-void VAO::Unbind() {
-	glBindVertexArray(0);
+void VAO::Unbind() const {
+	glStateBindVertexArray(0);
 }
 
 void VAO::Delete() {
-	glDeleteVertexArrays(1, &vaoObj);
+	vaoObj.reset();
 }
\ No newline at end of file
@@ -2,17 +2,19 @@
 #define VAO_H
 
 #include <glad/glad.h>
+#include "glHandle.hpp"
+#include "glState.hpp"
 #include "VBO.hpp"
 #include "EBO.hpp"
 
 class VAO {
 public:
-	GLuint vaoObj;
+	VertexArrayHandle vaoObj;
 
 	VAO();
-	void LinkAttri(VBO VBO, GLuint layout, GLuint numComponents, GLenum type, GLsizeiptr stride, void* offset, GLuint divisor = 0);
-	void Bind();
-	void Unbind();
+	void LinkAttri(const VBO& VBO, GLuint layout, GLuint numComponents, GLenum type, GLsizeiptr stride, void* offset, GLuint divisor = 0);
+	void Bind() const;
+	void Unbind() const;
 	void Delete();
 };
 
@@ -2,20 +2,23 @@
 
 //array with vertices, numElements (MULTIPLIED BY SIZEOF(VARIABLE), GL_STATIC_DRAW etc.)
 VBO::VBO(GLfloat* vertices, GLsizeiptr numElements, GLenum usage) {
-	glGenBuffers(1, &vboObj);
-	glBindBuffer(GL_ARRAY_BUFFER, vboObj);
+	GLuint name;
+	glGenBuffers(1, &name);
+	vboObj.reset(name);
+	glStateBindBuffer(GL_ARRAY_BUFFER, vboObj);
 	glBufferData(GL_ARRAY_BUFFER, numElements, vertices, usage);
 }
 
 
-void VBO::Bind() {
-	glBindBuffer(GL_ARRAY_BUFFER, vboObj);
+void VBO::Bind() const {
+	glStateBindBuffer(GL_ARRAY_BUFFER, vboObj);
 }
 
-void VBO::Unbind() {
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
+void VBO::Unbind() const {
+	glStateBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
+//early release, the destructor does the same. the name is deleted at the end of the frame
 void VBO::Delete() {
-	glDeleteBuffers(1, &vboObj);
+	vboObj.reset();
 }
\ No newline at end of file
@@ -2,14 +2,16 @@
 #define VBO_H
 
 #include <glad/glad.h>
+#include "glHandle.hpp"
+#include "glState.hpp"
 
 class VBO {
 	public:
-		GLuint vboObj;
+		BufferHandle vboObj;
 		VBO(GLfloat* vertices, GLsizeiptr numElements, GLenum usage);
 
-		void Bind();
-		void Unbind();
+		void Bind() const;
+		void Unbind() const;
 		void Delete();
 };
 
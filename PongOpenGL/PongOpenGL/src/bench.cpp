@@ -0,0 +1,324 @@
+#include "bench.hpp"
+#include "multiBall.hpp"
+#include "paddleAI.hpp"
+#include "pongBatch.hpp"
+#include "pongSim.hpp"
+#include "threadPool.hpp"
+#include "vecEnv.hpp"
+#include "net.hpp"
+#include "shmTransport.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+typedef std::chrono::steady_clock benchClock;
+
+static double secondsSince(benchClock::time_point start) {
+	return std::chrono::duration<double>(benchClock::now() - start).count();
+}
+
+//ticks/sec of one match on one core, straight through step() and through advance()'s accumulator
+void benchPongSim(float width, float height) {
+	const unsigned int chunk = 4096;
+	const char* paths[2] = { "step", "advance" };
+	unsigned int seed = 1;
+
+	std::cout << "path\tsteps/s\tns/step\tpoints" << std::endl;
+	for (int path = 0; path < 2; path++) {
+		PongSim sim(width, height);
+		unsigned long long steps = 0;
+		benchClock::time_point start = benchClock::now();
+		while (secondsSince(start) < 1.0) {
+			//the clock is only read between chunks so it doesn't show up in the time
+			for (unsigned int k = 0; k < chunk; k++) {
+				seed = seed * 1664525u + 1013904223u;
+				Inputs inputs = { (unsigned char)(seed >> 28) };
+				if (path == 0) {
+					sim.step(inputs, sim.tickDt);
+					steps++;
+				}
+				else {
+					steps += sim.advance(inputs, sim.tickDt);
+				}
+			}
+		}
+		double elapsed = secondsSince(start);
+
+		std::cout << paths[path] << "\t" << steps / elapsed << "\t" << elapsed / steps * 1e9 << "\t"
+			<< sim.state.scores[0] + sim.state.scores[1] << std::endl;
+	}
+}
+
+//steps/sec of party mode as the ball count grows, radius shrinks to keep the field 20% covered
+void benchMultiBall(float width, float height) {
+	const unsigned int counts[] = { 1000, 10000, 100000, 1000000 };
+	const float coverage = 0.2f;
+	const float dt = (float)(1.0 / simTickRate);
+	const float paddleY[2] = { height / 2.0f, height / 2.0f };
+
+	std::cout << "balls\tradius\tsteps/s\tballs/s\tcontacts" << std::endl;
+	for (unsigned int count : counts) {
+		float radius = sqrtf(coverage * width * height / (count * 3.14159265f));
+		MultiBall balls(count, width, height, radius);
+
+		//warm up, lets the balls spread out of their random overlaps
+		for (int i = 0; i < 10; i++) {
+			balls.step(paddleY, dt);
+		}
+
+		unsigned int steps = 0;
+		benchClock::time_point start = benchClock::now();
+		while (secondsSince(start) < 1.0) {
+			balls.step(paddleY, dt);
+			steps++;
+		}
+		double stepsPerSecond = steps / secondsSince(start);
+
+		std::cout << count << "\t" << radius << "\t" << stepsPerSecond << "\t"
+			<< stepsPerSecond * count << "\t" << balls.lastCollisions << std::endl;
+	}
+}
+
+//match steps/sec of PongBatch on 1..N threads, once cache sized and once far bigger than cache
+void benchBatchThreads(float width, float height, bool pinThreads) {
+	const unsigned int sizes[] = { 1 << 16, 1 << 22 };
+	const unsigned int chunk = 1024;
+	const float dt = (float)(1.0 / simTickRate);
+	unsigned int maxThreads = std::thread::hardware_concurrency();
+	maxThreads = maxThreads ? maxThreads : 1;
+
+	std::cout << "matches\tthreads\tsteps/s\tspeedup" << std::endl;
+	for (unsigned int size : sizes) {
+		PongBatch batch(size, width, height);
+		std::vector<unsigned char> buttons(batch.capacity);
+		for (unsigned int i = 0; i < batch.capacity; i++) {
+			buttons[i] = (unsigned char)(i % 16);
+		}
+
+		double single = 0.0;
+		for (unsigned int threads = 1; threads <= maxThreads; threads++) {
+			ThreadPool pool(threads, pinThreads);
+			ThreadPool::RangeFunction stepChunk = [&](unsigned int begin, unsigned int end) {
+				batch.step(buttons.data(), dt, begin, end);
+			};
+
+			//warm up so every page is touched before timing
+			pool.parallelFor(0, batch.capacity, chunk, stepChunk);
+
+			unsigned int steps = 0;
+			benchClock::time_point start = benchClock::now();
+			while (secondsSince(start) < 0.5) {
+				pool.parallelFor(0, batch.capacity, chunk, stepChunk);
+				steps++;
+			}
+			double matchSteps = (double)steps * size / secondsSince(start);
+			single = threads == 1 ? matchSteps : single;
+
+			std::cout << size << "\t" << threads << "\t" << matchSteps << "\t" << matchSteps / single << std::endl;
+		}
+	}
+}
+
+//cost of an 8 tick rollback plus resimulation, then a two peer run over localhost udp
+void benchRollback(float width, float height) {
+	const unsigned int depth = 8;
+	const unsigned int iterations = 100000;
+	unsigned int seed = 1;
+
+	PongSim sim(width, height);
+	RollbackSession session(sim, 0);
+
+	double total = 0.0;
+	double worst = 0.0;
+	for (unsigned int i = 0; i < iterations; i++) {
+		//run ahead on predictions, then learn every one of them was wrong
+		for (unsigned int k = 0; k < depth; k++) {
+			seed = seed * 1664525u + 1013904223u;
+			session.advance((unsigned char)(seed >> 28));
+		}
+		unsigned int first = session.currentTick() - depth;
+		for (unsigned int k = 0; k < depth; k++) {
+			session.addRemoteInput(first + k, (unsigned char)((i + k) & 1 ? INPUT_RIGHT_UP : INPUT_RIGHT_DOWN));
+		}
+
+		benchClock::time_point start = benchClock::now();
+		session.applyCorrections();
+		double elapsed = secondsSince(start);
+		total += elapsed;
+		worst = elapsed > worst ? elapsed : worst;
+	}
+	std::cout << depth << " tick rollback: mean " << total / iterations * 1e6 << "us, worst "
+		<< worst * 1e6 << "us over " << session.rollbacks << " rollbacks (budget 1000us)" << std::endl;
+
+	//two peers in one process, every packet goes through the loopback interface
+	const unsigned int ticks = 2000;
+	const unsigned short ports[2] = { 47000, 47001 };
+	PongSim sims[2] = { PongSim(width, height), PongSim(width, height) };
+	RollbackSession sessions[2] = { RollbackSession(sims[0], 0), RollbackSession(sims[1], 1) };
+	NetplayPeer peerA(sessions[0], ports[0], ports[1]);
+	NetplayPeer peerB(sessions[1], ports[1], ports[0]);
+	NetplayPeer* peers[2] = { &peerA, &peerB };
+	if (!peerA.isOpen() || !peerB.isOpen()) {
+		return;
+	}
+
+	benchClock::time_point start = benchClock::now();
+	while (secondsSince(start) < 10.0) {
+		bool finished = true;
+		for (int p = 0; p < 2; p++) {
+			RollbackSession& s = sessions[p];
+			if (s.currentTick() < ticks) {
+				//up to one tick's worth of time so neither overshoots, the peer stalls and resends on its own
+				double dt = peers[p]->accumulator >= sims[p].tickDt ? 0.0 : sims[p].tickDt;
+				seed = seed * 1664525u + 1013904223u;
+				peers[p]->update(dt, (unsigned char)(seed >> 28));
+			}
+			else {
+				//keep resending the tail until the other side has everything
+				peers[p]->receive();
+				peers[p]->send();
+				s.applyCorrections();
+			}
+			finished = finished && s.currentTick() == ticks && s.confirmedTick == ticks;
+		}
+		if (finished) {
+			break;
+		}
+	}
+
+	bool match = hashState(sims[0].state) == hashState(sims[1].state);
+	std::cout << "udp loopback: " << sessions[0].currentTick() << " ticks, "
+		<< sessions[0].rollbacks + sessions[1].rollbacks << " rollbacks, peers "
+		<< (match ? "in sync" : "DESYNCED") << std::endl;
+}
+
+//bot against bot on one core, how much of a tick the two ai passes cost
+void benchAI(float width, float height) {
+	const unsigned int matches = 1 << 16;
+	const float dt = (float)(1.0 / simTickRate);
+
+	PongBatch batch(matches, width, height);
+	BatchAI left(batch, 0);
+	BatchAI right(batch, 1, aiReactionDelay, aiError, 2);
+	std::vector<unsigned char> buttons(batch.capacity, 0);
+
+	unsigned int steps = 0;
+	double aiTime = 0.0;
+	benchClock::time_point start = benchClock::now();
+	while (secondsSince(start) < 2.0) {
+		benchClock::time_point thinkStart = benchClock::now();
+		left.think(batch, dt, buttons.data());
+		right.think(batch, dt, buttons.data());
+		aiTime += secondsSince(thinkStart);
+		batch.step(buttons.data(), dt);
+		steps++;
+	}
+	double elapsed = secondsSince(start);
+
+	unsigned long long points = 0;
+	for (unsigned int i = 0; i < matches; i++) {
+		points += batch.scores[0][i] + batch.scores[1][i];
+	}
+	double gameMinutes = (double)steps * dt / 60.0;
+
+	std::cout << matches << " bot matches: " << (double)steps * matches / elapsed << " match steps/s, ai "
+		<< aiTime / ((double)steps * matches) * 1e9 << "ns per match per tick ("
+		<< 100.0 * aiTime / elapsed << "% of the time), "
+		<< (double)points / matches / gameMinutes << " points per match minute" << std::endl;
+}
+
+//transitions/sec through the training api with random actions, buffers allocated once up front
+void benchVecEnv(float width, float height) {
+	const unsigned int sizes[] = { 1024, 16384, 262144 };
+	unsigned int seed = 1;
+
+	std::cout << "envs	transitions/s	episodes" << std::endl;
+	for (unsigned int size : sizes) {
+		VecEnv env(size, width, height);
+		std::vector<float> observations(size * envObservationSize);
+		std::vector<float> rewards(size);
+		std::vector<unsigned char> dones(size);
+		std::vector<unsigned char> actions(size);
+		env.setBuffers(observations.data(), rewards.data(), dones.data());
+		env.reset();
+
+		unsigned int steps = 0;
+		unsigned long long episodes = 0;
+		benchClock::time_point start = benchClock::now();
+		while (secondsSince(start) < 1.0) {
+			for (unsigned int i = 0; i < size; i++) {
+				seed = seed * 1664525u + 1013904223u;
+				actions[i] = (unsigned char)((seed >> 24) % 3);
+			}
+			env.step(actions.data());
+			for (unsigned int i = 0; i < size; i++) {
+				episodes += dones[i];
+			}
+			steps++;
+		}
+		std::cout << size << "\t" << (double)steps * size / secondsSince(start) << "\t" << episodes << std::endl;
+	}
+}
+
+//sim and trainer in two processes over the shared memory rings, the forked
+//trainer chases the ball so the batch sees real actions
+void benchShmTransport(float width, float height) {
+#ifdef _WIN32
+	(void)width;
+	(void)height;
+	std::cout << "Shared memory transport is not supported on this platform" << std::endl;
+#else
+	const unsigned int sizes[] = { 64, 4096, 65536 };
+	const char* name = "/pongopengl-bench";
+
+	std::cout << "envs\tround trips/s\ttransitions/s" << std::endl;
+	for (unsigned int size : sizes) {
+		shm_unlink(name);
+		ShmTransport server;
+		if (!server.create(name, size)) {
+			return;
+		}
+
+		pid_t child = fork();
+		if (child == 0) {
+			ShmTransport trainer;
+			if (trainer.attach(name)) {
+				benchClock::time_point start = benchClock::now();
+				while (secondsSince(start) < 1.0) {
+					const unsigned char* slot = trainer.steps.acquireRead();
+					unsigned char* actions = slot ? trainer.actions.acquireWrite() : NULL;
+					if (!actions) {
+						break;
+					}
+					const float* observations = trainer.stepSlot((unsigned char*)slot).observations;
+					for (unsigned int i = 0; i < size; i++) {
+						const float* row = observations + (size_t)i * envObservationSize;
+						actions[i] = row[1] > row[4] ? ACTION_UP : ACTION_DOWN;
+					}
+					trainer.actions.publishWrite();
+					trainer.steps.releaseRead();
+				}
+				trainer.shutdown();
+			}
+			_exit(0);
+		}
+
+		VecEnv env(size, width, height);
+		benchClock::time_point start = benchClock::now();
+		unsigned int served = serveVecEnv(env, server);
+		double elapsed = secondsSince(start);
+		waitpid(child, NULL, 0);
+
+		std::cout << size << "\t" << served / elapsed << "\t" << (double)served * size / elapsed << std::endl;
+	}
+#endif
+}
@@ -0,0 +1,16 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+/*
+	headless benchmarks, no GL or GLFW so they build into pongsim_bench on Linux
+	as well as the game (see runHeadless)
+*/
+void benchPongSim(float width, float height);
+void benchMultiBall(float width, float height);
+void benchBatchThreads(float width, float height, bool pinThreads);
+void benchRollback(float width, float height);
+void benchAI(float width, float height);
+void benchVecEnv(float width, float height);
+void benchShmTransport(float width, float height);
+
+#endif
@@ -0,0 +1,138 @@
+#include "benchGL.hpp"
+#include "glExt.hpp"
+#include <GLFW/glfw3.h>
+#include "sceneBatch.hpp"
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+typedef std::chrono::steady_clock benchClock;
+
+static double secondsSince(benchClock::time_point start) {
+	return std::chrono::duration<double>(benchClock::now() - start).count();
+}
+
+//frames/s streaming N balls a frame through the scene batch with each upload strategy, upload
+//is the cpu time spent mapping and filling the instances, waits counts frames it blocked on a fence
+void benchStreamUpload(GLFWwindow* window, float width, float height) {
+	const unsigned int counts[] = { 100, 1000, 10000, 100000, 1000000 };
+	const unsigned int warmupFrames = 10;
+	GLfloat quadVertices[] = { 0.5f, 0.5f, -0.5f, 0.5f, -0.5f, -0.5f, 0.5f, -0.5f };
+	GLuint quadIndices[] = { 0, 1, 2, 2, 3, 0 };
+
+	glfwSwapInterval(0);
+	std::cout << "mode\tballs\tframes/s\tupload ms\tMB/s\twaits" << std::endl;
+	for (unsigned int m = 0; m < STREAM_MODE_COUNT; m++) {
+		StreamMode mode = (StreamMode)m;
+		if (mode == STREAM_PERSISTENT && !glExt.bufferStorage) {
+			std::cout << streamModeName(mode) << "\tno GL_ARB_buffer_storage" << std::endl;
+			continue;
+		}
+
+		for (unsigned int count : counts) {
+			//last count's buffers
+			glFlushDeletes();
+
+			std::vector<GLfloat> positions((size_t)count * 2);
+			for (unsigned int i = 0; i < count; i++) {
+				positions[2 * i] = (float)(i % 997) / 997.0f * width;
+				positions[2 * i + 1] = (float)(i % 991) / 991.0f * height;
+			}
+			SceneBatch scene(mode);
+			unsigned int quad = scene.addMesh(quadVertices, 4, quadIndices, 6);
+			scene.uploadMeshes();
+
+			unsigned int frames = 0;
+			double uploadSeconds = 0.0;
+			benchClock::time_point start = benchClock::now();
+			while (frames <= warmupFrames || secondsSince(start) < 0.5) {
+				if (frames == warmupFrames) {
+					glFinish();
+					scene.instanceStream.waits = 0;
+					uploadSeconds = 0.0;
+					start = benchClock::now();
+				}
+				glClear(GL_COLOR_BUFFER_BIT);
+				benchClock::time_point uploadStart = benchClock::now();
+				scene.begin(count);
+				SceneInstance* balls = scene.add(quad, count);
+				if (!balls) {
+					scene.cancel();
+				}
+				//tiny balls so rasterizing doesn't drown out the upload
+				for (unsigned int i = 0; balls && i < count; i++) {
+					SceneInstance ball = { { positions[2 * i], positions[2 * i + 1] }, { 1.0f, 1.0f }, { 255, 255, 255, 255 }, 0.5f };
+					balls[i] = ball;
+				}
+				uploadSeconds += secondsSince(uploadStart);
+				scene.draw();
+				glfwSwapBuffers(window);
+				frames++;
+			}
+			glFinish();
+			double elapsed = secondsSince(start);
+			unsigned int timed = frames - warmupFrames;
+
+			std::cout << streamModeName(mode) << "\t" << count << "\t" << timed / elapsed << "\t"
+				<< uploadSeconds * 1000.0 / timed << "\t"
+				<< (double)timed * count * sizeof(SceneInstance) / elapsed / (1024.0 * 1024.0) << "\t"
+				<< scene.instanceStream.waits << std::endl;
+		}
+	}
+}
+
+void benchBallMeshes(GLFWwindow* window, float width, float height, StreamMode mode) {
+	const unsigned int counts[] = { 100, 1000, 10000, 100000 };
+	const unsigned int warmupFrames = 10;
+	const GLfloat ballSize = 20.0f;
+	GLfloat quadVertices[] = { 0.5f, 0.5f, -0.5f, 0.5f, -0.5f, -0.5f, 0.5f, -0.5f };
+	GLuint quadIndices[] = { 0, 1, 2, 2, 3, 0 };
+	std::vector<GLfloat> fanVertices;
+	std::vector<GLuint> fanIndices;
+	const unsigned int fanTriangles = 20;
+	gen2DCircleArray(fanVertices, fanIndices, fanTriangles);
+
+	SceneBatch scene(mode);
+	unsigned int meshes[2];
+	meshes[0] = scene.addMesh(fanVertices.data(), fanTriangles + 1, fanIndices.data(), 3 * fanTriangles);
+	meshes[1] = scene.addMesh(quadVertices, 4, quadIndices, 6);
+	scene.uploadMeshes();
+	const char* names[2] = { "fan", "sdf" };
+	const unsigned int meshVertices[2] = { fanTriangles + 1, 4 };
+	const GLfloat corners[2] = { 0.0f, 0.5f * ballSize };
+
+	glfwSwapInterval(0);
+	std::cout << "mesh	balls	frames/s	vertices/s" << std::endl;
+	for (unsigned int m = 0; m < 2; m++) {
+		for (unsigned int count : counts) {
+			unsigned int frames = 0;
+			benchClock::time_point start = benchClock::now();
+			while (frames <= warmupFrames || secondsSince(start) < 0.5) {
+				if (frames == warmupFrames) {
+					glFinish();
+					start = benchClock::now();
+				}
+				glClear(GL_COLOR_BUFFER_BIT);
+				scene.begin(count);
+				SceneInstance* instances = scene.add(meshes[m], count);
+				if (!instances) {
+					scene.cancel();
+				}
+				for (unsigned int i = 0; instances && i < count; i++) {
+					SceneInstance instance = { { (float)(i % 997) / 997.0f * width, (float)(i % 991) / 991.0f * height },
+						{ ballSize, ballSize }, { 255, 255, 255, 255 }, corners[m] };
+					instances[i] = instance;
+				}
+				scene.draw();
+				glfwSwapBuffers(window);
+				frames++;
+			}
+			glFinish();
+			double elapsed = secondsSince(start);
+			unsigned int timed = frames - warmupFrames;
+
+			std::cout << names[m] << "\t" << count << "\t" << timed / elapsed << "\t"
+				<< (double)timed * count * meshVertices[m] / elapsed << std::endl;
+		}
+	}
+}
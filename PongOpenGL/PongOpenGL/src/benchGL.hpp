@@ -0,0 +1,14 @@
+#ifndef BENCHGL_H
+#define BENCHGL_H
+
+#include "streamBuffer.hpp"
+
+/*
+	gl benchmarks, need a current context and an active shader
+*/
+struct GLFWwindow;
+void benchStreamUpload(GLFWwindow* window, float width, float height);
+//triangle fan balls against the sdf quad, same scene batch path for both
+void benchBallMeshes(GLFWwindow* window, float width, float height, StreamMode mode);
+
+#endif
@@ -0,0 +1,137 @@
+#ifndef FIXED_H
+#define FIXED_H
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+
+/*
+	fixed point number for deterministic simulation
+
+	16 fractional bits like Q16.16, but stored in 64 bits since the swept collision
+	squares velocities (1000^2 does not fit in 16 integer bits). every operation is
+	integer math so results are identical on any compiler, cpu or SIMD width.
+	conversion from float rounds to nearest, only do it on values that are already
+	deterministic (constants, the fixed tick).
+*/
+class Fixed {
+public:
+	static const int fractionBits = 16;
+	static const int64_t one = (int64_t)1 << fractionBits;
+
+	int64_t raw;
+
+	//trivial so PongState stays plain data for memcpy, memset and mmap
+	Fixed() = default;
+	constexpr Fixed(int i) : raw((int64_t)i * one) {}
+	constexpr Fixed(float f) : raw((int64_t)((double)f * one + (f < 0.0f ? -0.5 : 0.5))) {}
+	constexpr Fixed(double d) : raw((int64_t)(d * one + (d < 0.0 ? -0.5 : 0.5))) {}
+
+	static constexpr Fixed fromRaw(int64_t raw) {
+		Fixed f{};
+		f.raw = raw;
+		return f;
+	}
+
+	float toFloat() const {
+		return (float)((double)raw / one);
+	}
+
+	//(a * b) >> fractionBits without the 128 bit intermediate, split a into whole and
+	//fraction so squares like b * b in the sweep don't overflow. rounds toward zero
+	static constexpr int64_t multiplyRaw(int64_t a, int64_t b) {
+		uint64_t ua = a < 0 ? (uint64_t)-a : (uint64_t)a;
+		uint64_t ub = b < 0 ? (uint64_t)-b : (uint64_t)b;
+		uint64_t product = (ua >> fractionBits) * ub + (((ua & (one - 1)) * ub) >> fractionBits);
+		return (a < 0) != (b < 0) ? -(int64_t)product : (int64_t)product;
+	}
+
+	//(a << fractionBits) / b, rounds toward zero like the plain divide it replaces. the whole
+	//part is divided first so a past 2^47 doesn't overflow the shift, results that don't
+	//fit and a zero divisor saturate (and assert in debug) instead of trapping
+	static constexpr int64_t divideRaw(int64_t a, int64_t b) {
+		assert(b != 0 && "Fixed division by zero");
+		const int64_t saturated = (a < 0) != (b < 0) ? -INT64_MAX : INT64_MAX;
+		if (b == 0) {
+			return a == 0 ? 0 : saturated;
+		}
+		uint64_t ua = a < 0 ? (uint64_t)-a : (uint64_t)a;
+		uint64_t ub = b < 0 ? (uint64_t)-b : (uint64_t)b;
+		uint64_t whole = ua / ub;
+		uint64_t rest = ua % ub;
+		if (whole >> (63 - fractionBits)) {
+			return saturated;
+		}
+		uint64_t fraction = 0;
+		if (rest >> (63 - fractionBits)) {
+			//huge divisor, rest << fractionBits would overflow so go a bit at a time
+			for (int i = 0; i < fractionBits; i++) {
+				rest <<= 1;
+				fraction = (fraction << 1) | (rest >= ub ? 1 : 0);
+				rest -= rest >= ub ? ub : 0;
+			}
+		}
+		else {
+			fraction = (rest << fractionBits) / ub;
+		}
+		uint64_t quotient = (whole << fractionBits) + fraction;
+		return (a < 0) != (b < 0) ? -(int64_t)quotient : (int64_t)quotient;
+	}
+
+	Fixed operator-() const { return fromRaw(-raw); }
+	Fixed& operator+=(Fixed b) { raw += b.raw; return *this; }
+	Fixed& operator-=(Fixed b) { raw -= b.raw; return *this; }
+	Fixed& operator*=(Fixed b) { raw = multiplyRaw(raw, b.raw); return *this; }
+	Fixed& operator/=(Fixed b) { raw = divideRaw(raw, b.raw); return *this; }
+};
+
+inline Fixed operator+(Fixed a, Fixed b) { return Fixed::fromRaw(a.raw + b.raw); }
+inline Fixed operator-(Fixed a, Fixed b) { return Fixed::fromRaw(a.raw - b.raw); }
+inline Fixed operator*(Fixed a, Fixed b) { return Fixed::fromRaw(Fixed::multiplyRaw(a.raw, b.raw)); }
+inline Fixed operator/(Fixed a, Fixed b) { return Fixed::fromRaw(Fixed::divideRaw(a.raw, b.raw)); }
+
+inline bool operator<(Fixed a, Fixed b) { return a.raw < b.raw; }
+inline bool operator>(Fixed a, Fixed b) { return a.raw > b.raw; }
+inline bool operator<=(Fixed a, Fixed b) { return a.raw <= b.raw; }
+inline bool operator>=(Fixed a, Fixed b) { return a.raw >= b.raw; }
+inline bool operator==(Fixed a, Fixed b) { return a.raw == b.raw; }
+inline bool operator!=(Fixed a, Fixed b) { return a.raw != b.raw; }
+
+/*
+	helpers overloaded for float and Fixed so the physics can be written once
+*/
+
+inline float scalarAbs(float f) { return fabsf(f); }
+inline float scalarSqrt(float f) { return sqrtf(f); }
+inline float toFloat(float f) { return f; }
+
+inline Fixed scalarAbs(Fixed f) { return Fixed::fromRaw(f.raw < 0 ? -f.raw : f.raw); }
+inline float toFloat(Fixed f) { return f.toFloat(); }
+
+//integer square root of raw << fractionBits, bit by bit. past 2^31 the shift would
+//overflow, so take the root of raw and scale it back up (8 fewer fraction bits)
+inline Fixed scalarSqrt(Fixed f) {
+	if (f.raw <= 0) {
+		return Fixed::fromRaw(0);
+	}
+	bool large = f.raw >= ((int64_t)1 << 47);
+	uint64_t value = large ? (uint64_t)f.raw : (uint64_t)f.raw << Fixed::fractionBits;
+	uint64_t result = 0;
+	uint64_t bit = (uint64_t)1 << 62;
+	while (bit > value) {
+		bit >>= 2;
+	}
+	while (bit != 0) {
+		if (value >= result + bit) {
+			value -= result + bit;
+			result = (result >> 1) + bit;
+		}
+		else {
+			result >>= 1;
+		}
+		bit >>= 2;
+	}
+	return Fixed::fromRaw(large ? (int64_t)result << (Fixed::fractionBits / 2) : (int64_t)result);
+}
+
+#endif
@@ -0,0 +1,69 @@
+#include "glExt.hpp"
+#include <GLFW/glfw3.h>
+#include <cstring>
+
+GLExtensions glExt = {};
+
+GLEXTBUFFERSTORAGEPROC glExtBufferStorage = NULL;
+GLEXTDRAWELEMENTSINSTANCEDBASEVERTEXBASEINSTANCEPROC glExtDrawElementsInstancedBaseVertexBaseInstance = NULL;
+GLEXTMULTIDRAWELEMENTSINDIRECTPROC glExtMultiDrawElementsIndirect = NULL;
+GLEXTGETPROGRAMBINARYPROC glExtGetProgramBinary = NULL;
+GLEXTPROGRAMBINARYPROC glExtProgramBinary = NULL;
+GLEXTPROGRAMPARAMETERIPROC glExtProgramParameteri = NULL;
+GLEXTMAXSHADERCOMPILERTHREADSPROC glExtMaxShaderCompilerThreads = NULL;
+
+bool hasGLExtension(const char* name) {
+	GLint count = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+	for (GLint i = 0; i < count; i++) {
+		const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, (GLuint)i);
+		if (extension && strcmp(extension, name) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool hasGLVersion(int major, int minor) {
+	GLint haveMajor = 0;
+	GLint haveMinor = 0;
+	glGetIntegerv(GL_MAJOR_VERSION, &haveMajor);
+	glGetIntegerv(GL_MINOR_VERSION, &haveMinor);
+	return haveMajor > major || (haveMajor == major && haveMinor >= minor);
+}
+
+template <typename Proc>
+static bool loadProc(Proc& proc, const char* name) {
+	proc = (Proc)glfwGetProcAddress(name);
+	return proc != NULL;
+}
+
+void loadGLExtensions() {
+	glExt = GLExtensions();
+
+	if (hasGLVersion(4, 4) || hasGLExtension("GL_ARB_buffer_storage")) {
+		glExt.bufferStorage = loadProc(glExtBufferStorage, "glBufferStorage");
+	}
+	if (hasGLVersion(4, 2) || hasGLExtension("GL_ARB_base_instance")) {
+		glExt.baseInstance = loadProc(glExtDrawElementsInstancedBaseVertexBaseInstance, "glDrawElementsInstancedBaseVertexBaseInstance");
+	}
+	//indirect base instances are only honoured with GL_ARB_base_instance
+	if (glExt.baseInstance && (hasGLVersion(4, 3) || hasGLExtension("GL_ARB_multi_draw_indirect"))) {
+		glExt.multiDrawIndirect = loadProc(glExtMultiDrawElementsIndirect, "glMultiDrawElementsIndirect");
+	}
+	//drivers can expose the calls and still have no format to save in
+	if (hasGLVersion(4, 1) || hasGLExtension("GL_ARB_get_program_binary")) {
+		GLint formats = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+		glExt.programBinary = formats > 0
+			&& loadProc(glExtGetProgramBinary, "glGetProgramBinary")
+			&& loadProc(glExtProgramBinary, "glProgramBinary")
+			&& loadProc(glExtProgramParameteri, "glProgramParameteri");
+	}
+	if (hasGLExtension("GL_KHR_parallel_shader_compile")) {
+		glExt.parallelShaderCompile = loadProc(glExtMaxShaderCompilerThreads, "glMaxShaderCompilerThreadsKHR");
+	}
+	else if (hasGLExtension("GL_ARB_parallel_shader_compile")) {
+		glExt.parallelShaderCompile = loadProc(glExtMaxShaderCompilerThreads, "glMaxShaderCompilerThreadsARB");
+	}
+}
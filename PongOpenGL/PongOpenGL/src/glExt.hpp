@@ -0,0 +1,92 @@
+#ifndef GLEXT_H
+#define GLEXT_H
+
+#include <glad/glad.h>
+
+/*
+	gl entry points above the 3.3 core glad was generated for
+
+	loaded by hand after glad, each group is only called when its flag in glExt
+	says the context has it (newer core version or the matching extension)
+*/
+struct GLExtensions {
+	bool bufferStorage;		//4.4 or GL_ARB_buffer_storage
+	bool baseInstance;		//4.2 or GL_ARB_base_instance
+	bool multiDrawIndirect;	//4.3 or GL_ARB_multi_draw_indirect (with base instance)
+	bool programBinary;		//4.1 or GL_ARB_get_program_binary, with at least one binary format
+	bool parallelShaderCompile;	//GL_KHR_parallel_shader_compile or GL_ARB_parallel_shader_compile
+};
+
+extern GLExtensions glExt;
+
+//call once after loadGlad with the context current
+void loadGLExtensions();
+bool hasGLExtension(const char* name);
+
+/*
+	GL_ARB_buffer_storage
+*/
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
+#define GL_DYNAMIC_STORAGE_BIT 0x0100
+#define GL_CLIENT_STORAGE_BIT 0x0200
+#endif
+
+typedef void (APIENTRYP GLEXTBUFFERSTORAGEPROC)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+extern GLEXTBUFFERSTORAGEPROC glExtBufferStorage;
+
+/*
+	GL_ARB_base_instance
+*/
+typedef void (APIENTRYP GLEXTDRAWELEMENTSINSTANCEDBASEVERTEXBASEINSTANCEPROC)(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instanceCount, GLint baseVertex, GLuint baseInstance);
+extern GLEXTDRAWELEMENTSINSTANCEDBASEVERTEXBASEINSTANCEPROC glExtDrawElementsInstancedBaseVertexBaseInstance;
+
+/*
+	GL_ARB_draw_indirect / GL_ARB_multi_draw_indirect
+*/
+#ifndef GL_DRAW_INDIRECT_BUFFER
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#endif
+
+//layout fixed by the spec, one per draw in the indirect buffer
+struct DrawElementsIndirectCommand {
+	GLuint count;
+	GLuint instanceCount;
+	GLuint firstIndex;
+	GLint baseVertex;
+	GLuint baseInstance;
+};
+
+typedef void (APIENTRYP GLEXTMULTIDRAWELEMENTSINDIRECTPROC)(GLenum mode, GLenum type, const void* indirect, GLsizei drawCount, GLsizei stride);
+extern GLEXTMULTIDRAWELEMENTSINDIRECTPROC glExtMultiDrawElementsIndirect;
+
+/*
+	GL_ARB_get_program_binary
+*/
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#define GL_PROGRAM_BINARY_FORMATS 0x87FF
+#endif
+
+typedef void (APIENTRYP GLEXTGETPROGRAMBINARYPROC)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+typedef void (APIENTRYP GLEXTPROGRAMBINARYPROC)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+typedef void (APIENTRYP GLEXTPROGRAMPARAMETERIPROC)(GLuint program, GLenum pname, GLint value);
+extern GLEXTGETPROGRAMBINARYPROC glExtGetProgramBinary;
+extern GLEXTPROGRAMBINARYPROC glExtProgramBinary;
+extern GLEXTPROGRAMPARAMETERIPROC glExtProgramParameteri;
+
+/*
+	GL_KHR_parallel_shader_compile (same enums as the ARB version)
+*/
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+typedef void (APIENTRYP GLEXTMAXSHADERCOMPILERTHREADSPROC)(GLuint count);
+extern GLEXTMAXSHADERCOMPILERTHREADSPROC glExtMaxShaderCompilerThreads;
+
+#endif
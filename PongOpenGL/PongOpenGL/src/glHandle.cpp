@@ -0,0 +1,40 @@
+#include "glHandle.hpp"
+#include "glState.hpp"
+#include <vector>
+
+static std::vector<GLuint> pending[GLOBJECT_KIND_COUNT];
+static std::vector<GLsync> pendingSyncs;
+
+void glDeferDelete(GLObjectKind kind, GLuint name) {
+	pending[kind].push_back(name);
+}
+
+void glDeferDeleteSync(GLsync sync) {
+	pendingSyncs.push_back(sync);
+}
+
+void glFlushDeletes() {
+	std::vector<GLuint>& buffers = pending[GLOBJECT_BUFFER];
+	if (!buffers.empty()) {
+		glStateDeleteBuffers((GLsizei)buffers.size(), buffers.data());
+		buffers.clear();
+	}
+	std::vector<GLuint>& vertexArrays = pending[GLOBJECT_VERTEX_ARRAY];
+	if (!vertexArrays.empty()) {
+		glStateDeleteVertexArrays((GLsizei)vertexArrays.size(), vertexArrays.data());
+		vertexArrays.clear();
+	}
+	//programs have no batched delete
+	for (GLuint program : pending[GLOBJECT_PROGRAM]) {
+		glStateDeleteProgram(program);
+	}
+	pending[GLOBJECT_PROGRAM].clear();
+	for (GLuint shader : pending[GLOBJECT_SHADER]) {
+		glDeleteShader(shader);
+	}
+	pending[GLOBJECT_SHADER].clear();
+	for (GLsync sync : pendingSyncs) {
+		glDeleteSync(sync);
+	}
+	pendingSyncs.clear();
+}
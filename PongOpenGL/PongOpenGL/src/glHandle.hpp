@@ -0,0 +1,73 @@
+#ifndef GLHANDLE_H
+#define GLHANDLE_H
+
+#include <glad/glad.h>
+
+/*
+	owning, move only gl object names with deferred deletion
+
+	a handle going away (or reset to another name) only queues its name, the
+	queue is deleted in one glDelete* call per kind at the end of the frame. a
+	scene rebuilt mid frame never stalls on objects the gpu may still be reading,
+	and nothing is leaked when a wrapper is replaced.
+*/
+
+enum GLObjectKind {
+	GLOBJECT_BUFFER,
+	GLOBJECT_VERTEX_ARRAY,
+	GLOBJECT_PROGRAM,
+	GLOBJECT_SHADER,
+	GLOBJECT_KIND_COUNT
+};
+
+void glDeferDelete(GLObjectKind kind, GLuint name);
+void glDeferDeleteSync(GLsync sync);
+//once per frame after the swap, and before the context goes away
+void glFlushDeletes();
+
+template <GLObjectKind Kind>
+class GLHandle {
+public:
+	GLHandle() : name(0) {}
+	explicit GLHandle(GLuint name) : name(name) {}
+	~GLHandle() {
+		reset();
+	}
+
+	GLHandle(const GLHandle&) = delete;
+	GLHandle& operator=(const GLHandle&) = delete;
+
+	GLHandle(GLHandle&& other) noexcept : name(other.name) {
+		other.name = 0;
+	}
+	GLHandle& operator=(GLHandle&& other) noexcept {
+		if (this != &other) {
+			reset(other.name);
+			other.name = 0;
+		}
+		return *this;
+	}
+
+	//reads like the raw name at gl call sites
+	operator GLuint() const {
+		return name;
+	}
+
+	//queues the old name, takes ownership of the new one
+	void reset(GLuint newName = 0) {
+		if (name) {
+			glDeferDelete(Kind, name);
+		}
+		name = newName;
+	}
+
+private:
+	GLuint name;
+};
+
+typedef GLHandle<GLOBJECT_BUFFER> BufferHandle;
+typedef GLHandle<GLOBJECT_VERTEX_ARRAY> VertexArrayHandle;
+typedef GLHandle<GLOBJECT_PROGRAM> ProgramHandle;
+typedef GLHandle<GLOBJECT_SHADER> ShaderHandle;
+
+#endif
@@ -0,0 +1,137 @@
+#include "glState.hpp"
+#include "glExt.hpp"
+
+//never a real object name, forces the next bind through
+const GLuint unknownBinding = 0xFFFFFFFFu;
+
+enum GLStateTarget {
+	TARGET_ARRAY,
+	TARGET_ELEMENT_ARRAY,
+	TARGET_UNIFORM,
+	TARGET_DRAW_INDIRECT,
+	TARGET_COUNT
+};
+
+struct GLStateCache {
+	GLuint buffers[TARGET_COUNT];
+	GLuint vertexArray;
+	GLuint program;
+	GLStateCounters counters;
+};
+
+static GLStateCache cache = {
+	{ unknownBinding, unknownBinding, unknownBinding, unknownBinding },
+	unknownBinding,
+	unknownBinding,
+	{}
+};
+
+//-1 for targets that aren't tracked, those are always issued
+static int targetIndex(GLenum target) {
+	switch (target) {
+	case GL_ARRAY_BUFFER: return TARGET_ARRAY;
+	case GL_ELEMENT_ARRAY_BUFFER: return TARGET_ELEMENT_ARRAY;
+	case GL_UNIFORM_BUFFER: return TARGET_UNIFORM;
+	case GL_DRAW_INDIRECT_BUFFER: return TARGET_DRAW_INDIRECT;
+	default: return -1;
+	}
+}
+
+//true if the call has to go to gl
+static bool track(GLStateCall call, GLuint& cached, GLuint value) {
+	if (cached == value) {
+		cache.counters.elided[call]++;
+		return false;
+	}
+	cached = value;
+	cache.counters.issued[call]++;
+	return true;
+}
+
+void glStateBindBuffer(GLenum target, GLuint buffer) {
+	int index = targetIndex(target);
+	if (index < 0) {
+		cache.counters.issued[GLSTATE_BUFFER]++;
+		glBindBuffer(target, buffer);
+		return;
+	}
+	if (track(GLSTATE_BUFFER, cache.buffers[index], buffer)) {
+		glBindBuffer(target, buffer);
+	}
+}
+
+//indexed points aren't cached, only the generic binding they overwrite
+void glStateBindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+	glBindBufferBase(target, index, buffer);
+	cache.counters.issued[GLSTATE_BUFFER]++;
+	int slot = targetIndex(target);
+	if (slot >= 0) {
+		cache.buffers[slot] = buffer;
+	}
+}
+
+void glStateBindVertexArray(GLuint vertexArray) {
+	if (track(GLSTATE_VERTEX_ARRAY, cache.vertexArray, vertexArray)) {
+		glBindVertexArray(vertexArray);
+		cache.buffers[TARGET_ELEMENT_ARRAY] = unknownBinding;
+	}
+}
+
+void glStateUseProgram(GLuint program) {
+	if (track(GLSTATE_PROGRAM, cache.program, program)) {
+		glUseProgram(program);
+	}
+}
+
+void glStateDeleteBuffers(GLsizei count, const GLuint* buffers) {
+	glDeleteBuffers(count, buffers);
+	for (GLsizei n = 0; n < count; n++) {
+		for (unsigned int i = 0; i < TARGET_COUNT; i++) {
+			if (cache.buffers[i] == buffers[n]) {
+				cache.buffers[i] = 0;
+			}
+		}
+	}
+}
+
+void glStateDeleteVertexArrays(GLsizei count, const GLuint* vertexArrays) {
+	glDeleteVertexArrays(count, vertexArrays);
+	for (GLsizei n = 0; n < count; n++) {
+		if (cache.vertexArray == vertexArrays[n]) {
+			cache.vertexArray = 0;
+			cache.buffers[TARGET_ELEMENT_ARRAY] = unknownBinding;
+		}
+	}
+}
+
+//a deleted program stays in use until another is bound but its name is free for
+//reuse, so the cache can't trust it any more
+void glStateDeleteProgram(GLuint program) {
+	glDeleteProgram(program);
+	if (cache.program == program) {
+		cache.program = unknownBinding;
+	}
+}
+
+void glStateReset() {
+	for (unsigned int i = 0; i < TARGET_COUNT; i++) {
+		cache.buffers[i] = unknownBinding;
+	}
+	cache.vertexArray = unknownBinding;
+	cache.program = unknownBinding;
+}
+
+GLStateCounters glStateEndFrame() {
+	GLStateCounters counters = cache.counters;
+	cache.counters = GLStateCounters();
+	return counters;
+}
+
+const char* glStateCallName(GLStateCall call) {
+	switch (call) {
+	case GLSTATE_BUFFER: return "buffer";
+	case GLSTATE_VERTEX_ARRAY: return "vao";
+	case GLSTATE_PROGRAM: return "program";
+	default: return "?";
+	}
+}
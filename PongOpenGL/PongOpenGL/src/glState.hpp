@@ -0,0 +1,44 @@
+#ifndef GLSTATE_H
+#define GLSTATE_H
+
+#include <glad/glad.h>
+
+/*
+	shadow copy of the gl bindings, every wrapper binds through here
+
+	a bind that would not change anything is skipped and counted. the element
+	array binding belongs to the bound vao, so it is forgotten whenever the vao
+	changes. code that binds behind the cache's back has to call glStateReset.
+*/
+
+enum GLStateCall {
+	GLSTATE_BUFFER,
+	GLSTATE_VERTEX_ARRAY,
+	GLSTATE_PROGRAM,
+	GLSTATE_CALL_COUNT
+};
+
+struct GLStateCounters {
+	unsigned int issued[GLSTATE_CALL_COUNT];
+	unsigned int elided[GLSTATE_CALL_COUNT];
+};
+
+void glStateBindBuffer(GLenum target, GLuint buffer);
+void glStateBindVertexArray(GLuint vertexArray);
+void glStateUseProgram(GLuint program);
+//binds the indexed point and, like gl, the generic target too
+void glStateBindBufferBase(GLenum target, GLuint index, GLuint buffer);
+
+//deleting a bound object unbinds it, these keep the cache in step
+void glStateDeleteBuffers(GLsizei count, const GLuint* buffers);
+void glStateDeleteVertexArrays(GLsizei count, const GLuint* vertexArrays);
+void glStateDeleteProgram(GLuint program);
+
+//forget everything, the next bind of each kind is always issued
+void glStateReset();
+
+//counts since the last call, once per frame
+GLStateCounters glStateEndFrame();
+const char* glStateCallName(GLStateCall call);
+
+#endif
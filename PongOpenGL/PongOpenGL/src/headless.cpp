@@ -0,0 +1,319 @@
+#include "headless.hpp"
+#include "bench.hpp"
+#include "paddleAI.hpp"
+#include "pongBatch.hpp"
+#include "replay.hpp"
+#include "shmTransport.hpp"
+#include "vecEnv.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+bool runHeadless(int argc, char** argv, float width, float height, int& exitCode) {
+	exitCode = 0;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--bench-sim") == 0) {
+			benchPongSim(width, height);
+			return true;
+		}
+		if (strcmp(argv[i], "--bench-multiball") == 0) {
+			benchMultiBall(width, height);
+			return true;
+		}
+		if (strcmp(argv[i], "--bench-threads") == 0) {
+			benchBatchThreads(width, height, i + 1 < argc && strcmp(argv[i + 1], "--pin") == 0);
+			return true;
+		}
+		if (strcmp(argv[i], "--bench-rollback") == 0) {
+			benchRollback(width, height);
+			return true;
+		}
+		if (strcmp(argv[i], "--bench-ai") == 0) {
+			benchAI(width, height);
+			return true;
+		}
+		if (strcmp(argv[i], "--bench-vecenv") == 0) {
+			benchVecEnv(width, height);
+			return true;
+		}
+		if (strcmp(argv[i], "--bench-shm") == 0) {
+			benchShmTransport(width, height);
+			return true;
+		}
+		if (strcmp(argv[i], "--shm-serve") == 0 && i + 2 < argc) {
+			exitCode = serveSharedMemory(argv[i + 1], (unsigned int)atoi(argv[i + 2]), width, height);
+			return true;
+		}
+		if (strcmp(argv[i], "--test-batch") == 0) {
+			exitCode = testBatchHeadless(1001, 20000, width, height);
+			return true;
+		}
+		if (strcmp(argv[i], "--test-ai") == 0) {
+			exitCode = testAIHeadless(1001, 20000, width, height);
+			return true;
+		}
+		if (strcmp(argv[i], "--test-shm") == 0) {
+			exitCode = testShmHeadless(61, 1000, width, height);
+			return true;
+		}
+		if (strcmp(argv[i], "--play") == 0 && i + 1 < argc) {
+			exitCode = playReplayHeadless(argv[i + 1]);
+			return true;
+		}
+		if (strcmp(argv[i], "--verify") == 0 && i + 1 < argc) {
+			exitCode = verifyReplayHeadless(argv[i + 1]);
+			return true;
+		}
+	}
+	return false;
+}
+
+//run a whole replay without a window and report how fast it went
+int playReplayHeadless(const char* filename) {
+	ReplayReader reader(filename);
+	if (!reader.isOpen()) {
+		return -1;
+	}
+
+	ReplayPlayer player(reader);
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	player.playTo(reader.tickCount);
+	double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	std::cout << "Played " << player.tick() << " ticks in " << elapsed << "s ("
+		<< player.tick() / (elapsed > 0.0 ? elapsed : 1e-9) << " ticks/s, "
+		<< player.tick() * reader.header.tickDt / (elapsed > 0.0 ? elapsed : 1e-9) << "x real time)" << std::endl;
+	std::cout << "Score " << player.sim.state.scores[0] << " - " << player.sim.state.scores[1] << std::endl;
+	return 0;
+}
+
+//re-simulate a replay and check it against its keyframes, run the same file through
+//two builds (e.g. different compilers with PONG_FIXED_POINT) and compare the hashes
+int verifyReplayHeadless(const char* filename) {
+	ReplayReader reader(filename);
+	if (!reader.isOpen()) {
+		return -1;
+	}
+
+	ReplayPlayer player(reader);
+	unsigned int mismatchTick = 0;
+	uint64_t traceHash = 0;
+	if (!player.verify(mismatchTick, traceHash)) {
+		std::cout << "Replay diverged at tick " << mismatchTick << std::endl;
+		return 1;
+	}
+	std::cout << "Replay matches over " << player.tick() << " ticks, hash "
+		<< std::hex << traceHash << std::dec << std::endl;
+	return 0;
+}
+
+//every ball somewhere random, heading any way at 100-610 px/s
+static void scatterBalls(PongBatch& batch, unsigned int& seed) {
+	for (unsigned int i = 0; i < batch.capacity; i++) {
+		seed = seed * 1664525u + 1013904223u;
+		float angle = (float)(seed >> 8) / (float)(1 << 24) * 6.2831853f;
+		float speed = 100.0f + (float)(seed & 0xFF) * 2.0f;
+		batch.ballX[i] = (float)(seed % (unsigned int)batch.width);
+		batch.ballY[i] = (float)((seed >> 12) % (unsigned int)batch.height);
+		batch.ballVX[i] = speed * cosf(angle);
+		batch.ballVY[i] = speed * sinf(angle);
+	}
+}
+
+//step() against stepScalar() on random inputs from varied starts, every array compared every tick.
+//the match count is odd so the padding lanes are exercised. the trace hash chains every tick,
+//run it in an sse2, an avx2 and a non simd build and the hashes must agree too
+int testBatchHeadless(unsigned int matches, unsigned int ticks, float width, float height) {
+	PongBatch simd(matches, width, height);
+	PongBatch scalar(matches, width, height);
+	std::vector<unsigned char> buttons(simd.capacity, 0);
+	const float dt = (float)(1.0 / simTickRate);
+	unsigned int seed = 12345;
+	unsigned int scalarSeed = seed;
+	scatterBalls(simd, seed);
+	scatterBalls(scalar, scalarSeed);
+
+	uint64_t traceHash = hashSeed;
+	for (unsigned int tick = 0; tick < ticks; tick++) {
+		for (unsigned int i = 0; i < simd.capacity; i++) {
+			seed = seed * 1664525u + 1013904223u;
+			buttons[i] = (unsigned char)(seed >> 28);
+		}
+		simd.step(buttons.data(), dt);
+		scalar.stepScalar(buttons.data(), dt);
+
+		const void* a[] = { simd.ballX, simd.ballY, simd.ballVX, simd.ballVY, simd.paddleY[0], simd.paddleY[1], simd.scores[0], simd.scores[1], simd.points };
+		const void* b[] = { scalar.ballX, scalar.ballY, scalar.ballVX, scalar.ballVY, scalar.paddleY[0], scalar.paddleY[1], scalar.scores[0], scalar.scores[1], scalar.points };
+		const size_t sizes[] = { 4, 4, 4, 4, 4, 4, sizeof(unsigned int), sizeof(unsigned int), 1 };
+		const char* names[] = { "ballX", "ballY", "ballVX", "ballVY", "paddleY[0]", "paddleY[1]", "scores[0]", "scores[1]", "points" };
+		for (unsigned int k = 0; k < 9; k++) {
+			if (memcmp(a[k], b[k], matches * sizes[k]) != 0) {
+				std::cout << "Batch step and stepScalar differ in " << names[k] << " at tick " << tick << std::endl;
+				return 1;
+			}
+			traceHash = hashBytes(traceHash, a[k], matches * sizes[k]);
+		}
+	}
+	std::cout << "Batch step matches stepScalar over " << ticks << " ticks of " << matches
+		<< " matches (simd width " << simdWidth << "), hash " << std::hex << traceHash << std::dec << std::endl;
+	return 0;
+}
+
+//think() against thinkScalar() for both sides of one batch, the simd controllers drive the
+//matches and the scalar ones watch the same states. buttons, targets, timers and rng streams
+//are compared every tick, the match count is odd for the padding lanes again
+int testAIHeadless(unsigned int matches, unsigned int ticks, float width, float height) {
+	PongBatch batch(matches, width, height);
+	BatchAI simd[2] = { BatchAI(batch, 0), BatchAI(batch, 1, aiReactionDelay, aiError, 2) };
+	BatchAI scalar[2] = { BatchAI(batch, 0), BatchAI(batch, 1, aiReactionDelay, aiError, 2) };
+	std::vector<unsigned char> simdButtons(batch.capacity, 0);
+	std::vector<unsigned char> scalarButtons(batch.capacity, 0);
+	const float dt = (float)(1.0 / simTickRate);
+	unsigned int seed = 54321;
+	scatterBalls(batch, seed);
+	//a few balls that never move sideways, the predictor has to leave them where they are,
+	//and a few barely moving sideways so the unfolded y is folded from past 2^31 periods,
+	//where a truncating vfloor goes wrong
+	for (unsigned int i = 0; i < batch.capacity; i += 97) {
+		batch.ballVX[i] = 0.0f;
+	}
+	for (unsigned int i = 1; i < batch.capacity; i += 89) {
+		batch.ballVX[i] = batch.ballVX[i] < 0.0f ? -1e-7f : 1e-7f;
+	}
+
+	uint64_t traceHash = hashSeed;
+	for (unsigned int tick = 0; tick < ticks; tick++) {
+		for (int side = 0; side < 2; side++) {
+			simd[side].think(batch, dt, simdButtons.data());
+			scalar[side].thinkScalar(batch, dt, scalarButtons.data());
+
+			const void* a[] = { simd[side].target, simd[side].waiting, simd[side].rng };
+			const void* b[] = { scalar[side].target, scalar[side].waiting, scalar[side].rng };
+			const char* names[] = { "target", "waiting", "rng" };
+			for (unsigned int k = 0; k < 3; k++) {
+				if (memcmp(a[k], b[k], matches * 4) != 0) {
+					std::cout << "BatchAI think and thinkScalar differ in side " << side << " " << names[k] << " at tick " << tick << std::endl;
+					return 1;
+				}
+				traceHash = hashBytes(traceHash, a[k], matches * 4);
+			}
+		}
+		if (memcmp(simdButtons.data(), scalarButtons.data(), matches) != 0) {
+			std::cout << "BatchAI think and thinkScalar differ in buttons at tick " << tick << std::endl;
+			return 1;
+		}
+		traceHash = hashBytes(traceHash, simdButtons.data(), matches);
+		batch.step(simdButtons.data(), dt);
+	}
+
+	unsigned long long points = 0;
+	for (unsigned int i = 0; i < matches; i++) {
+		points += batch.scores[0][i] + batch.scores[1][i];
+	}
+	std::cout << "BatchAI think matches thinkScalar over " << ticks << " ticks of " << matches
+		<< " matches (simd width " << simdWidth << ", " << points << " points), hash " << std::hex << traceHash << std::dec << std::endl;
+	return 0;
+}
+
+//sim and a forked trainer over the shared memory rings, the trainer steps its own VecEnv with
+//the same actions and every step slot has to match it byte for byte. the ring counters start
+//just short of 2^32 so the slots are handed out across the wrap
+int testShmHeadless(unsigned int envCount, unsigned int rounds, float width, float height) {
+#ifdef _WIN32
+	(void)envCount;
+	(void)rounds;
+	(void)width;
+	(void)height;
+	std::cout << "Shared memory transport is not supported on this platform" << std::endl;
+	return 0;
+#else
+	const char* name = "/pongopengl-test";
+	const uint32_t nearWrap = 0xFFFFFFFFu - 2 * shmSlotCount;
+	shm_unlink(name);
+	ShmTransport server;
+	if (!server.create(name, envCount)) {
+		return 1;
+	}
+	ShmRingControl* rings[2] = { &server.header->steps, &server.header->actions };
+	for (ShmRingControl* ring : rings) {
+		ring->head.store(nearWrap);
+		ring->tail.store(nearWrap);
+	}
+
+	pid_t child = fork();
+	if (child == 0) {
+		ShmTransport trainer;
+		if (!trainer.attach(name)) {
+			_exit(1);
+		}
+		VecEnv local(envCount, width, height);
+		std::vector<float> observations(envCount * envObservationSize);
+		std::vector<float> rewards(envCount);
+		std::vector<unsigned char> dones(envCount);
+		local.setBuffers(observations.data(), rewards.data(), dones.data());
+		local.reset();
+
+		int status = 0;
+		for (unsigned int round = 0; round < rounds && status == 0; round++) {
+			const unsigned char* slot = trainer.steps.acquireRead();
+			unsigned char* actions = slot ? trainer.actions.acquireWrite() : NULL;
+			if (!actions) {
+				status = 1;
+				break;
+			}
+			StepSlot step = trainer.stepSlot((unsigned char*)slot);
+			if (memcmp(step.observations, observations.data(), observations.size() * sizeof(float)) != 0 ||
+				memcmp(step.rewards, rewards.data(), rewards.size() * sizeof(float)) != 0 ||
+				memcmp(step.dones, dones.data(), dones.size()) != 0) {
+				std::cout << "Shared memory step differs from a local VecEnv at round " << round << std::endl;
+				status = 1;
+				break;
+			}
+			for (unsigned int i = 0; i < envCount; i++) {
+				const float* row = observations.data() + (size_t)i * envObservationSize;
+				actions[i] = row[1] > row[4] ? ACTION_UP : ACTION_DOWN;
+			}
+			local.step(actions);
+			trainer.actions.publishWrite();
+			trainer.steps.releaseRead();
+		}
+		trainer.shutdown();
+		_exit(status);
+	}
+
+	VecEnv env(envCount, width, height);
+	unsigned int served = serveVecEnv(env, server);
+	int status = 0;
+	waitpid(child, &status, 0);
+	if (!WIFEXITED(status) || WEXITSTATUS(status) != 0 || served + 1 < rounds) {
+		std::cout << "Shared memory transport failed after " << served << " steps" << std::endl;
+		return 1;
+	}
+	std::cout << "Shared memory transport matches a local VecEnv over " << served << " steps of "
+		<< envCount << " envs, across the index wrap" << std::endl;
+	return 0;
+#endif
+}
+
+//env server for a trainer in another process, runs until the trainer shuts the transport down
+int serveSharedMemory(const char* name, unsigned int envCount, float width, float height) {
+	ShmTransport transport;
+	if (!transport.create(name, envCount)) {
+		return -1;
+	}
+
+	std::cout << "Serving " << envCount << " envs on " << name << std::endl;
+	VecEnv env(envCount, width, height);
+	unsigned int steps = serveVecEnv(env, transport);
+	std::cout << "Served " << steps << " steps" << std::endl;
+	return 0;
+}
@@ -0,0 +1,27 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+/*
+	command line modes that need no window, shared by the game and pongsim_bench
+
+	--bench-sim, --bench-multiball, --bench-threads [--pin], --bench-rollback,
+	--bench-ai, --bench-vecenv, --bench-shm, --shm-serve NAME ENVS,
+	--test-batch, --test-ai, --test-shm, --play FILE, --verify FILE
+
+	the --test modes return non zero on failure, ctest runs them
+*/
+
+//runs the first headless mode on the command line, false if there is none
+bool runHeadless(int argc, char** argv, float width, float height, int& exitCode);
+
+int playReplayHeadless(const char* filename);
+int verifyReplayHeadless(const char* filename);
+//exits 1 as soon as step() and stepScalar() differ
+int testBatchHeadless(unsigned int matches, unsigned int ticks, float width, float height);
+//exits 1 as soon as BatchAI think() and thinkScalar() differ
+int testAIHeadless(unsigned int matches, unsigned int ticks, float width, float height);
+//exits 1 if a trainer process sees anything but what a local VecEnv produces
+int testShmHeadless(unsigned int envCount, unsigned int rounds, float width, float height);
+int serveSharedMemory(const char* name, unsigned int envCount, float width, float height);
+
+#endif
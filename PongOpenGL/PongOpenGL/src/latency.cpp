@@ -0,0 +1,197 @@
+#include "latency.hpp"
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+//nanoseconds from a to b, 0 if the clock went the other way
+static uint64_t nanosecondsBetween(simClock::time_point a, simClock::time_point b) {
+	long long ns = (long long)std::chrono::duration_cast<std::chrono::nanoseconds>(b - a).count();
+	return ns > 0 ? (uint64_t)ns : 0;
+}
+
+static double toMicroseconds(uint64_t ns) {
+	return ns / 1000.0;
+}
+
+const char* latencyStageName(LatencyStage stage) {
+	switch (stage) {
+	case LATENCY_SIM: return "input->sim";
+	case LATENCY_PICKUP: return "sim->read";
+	case LATENCY_UPLOAD: return "read->upload";
+	case LATENCY_SUBMIT: return "upload->submit";
+	case LATENCY_SWAP: return "submit->swap";
+	case LATENCY_GPU: return "swap->gpu";
+	case LATENCY_TOTAL: return "total";
+	default: return "?";
+	}
+}
+
+/*
+	HISTOGRAM
+*/
+
+LatencyHistogram::LatencyHistogram() : count(0), min(UINT64_MAX), max(0), total(0.0), counts(bucketCount, 0) {}
+
+//values under subBucketCount index themselves, above that the top subBucketBits
+//bits pick the bucket inside the value's power of two
+unsigned int LatencyHistogram::indexOf(uint64_t value) {
+	if (value < subBucketCount) {
+		return (unsigned int)value;
+	}
+	unsigned int bits = subBucketBits;
+	while (bits < 64 && (value >> bits) != 0) {
+		bits++;
+	}
+	unsigned int shift = bits - subBucketBits;
+	unsigned int top = (unsigned int)(value >> shift);
+	return subBucketCount + (shift - 1) * subBucketHalf + (top - subBucketHalf);
+}
+
+uint64_t LatencyHistogram::highestEquivalent(unsigned int index) {
+	if (index < subBucketCount) {
+		return index;
+	}
+	unsigned int shift = (index - subBucketCount) / subBucketHalf + 1;
+	uint64_t top = (index - subBucketCount) % subBucketHalf + subBucketHalf;
+	return ((top + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t value) {
+	counts[indexOf(value)]++;
+	count++;
+	min = value < min ? value : min;
+	max = value > max ? value : max;
+	total += (double)value;
+}
+
+uint64_t LatencyHistogram::percentile(double percent) const {
+	if (!count) {
+		return 0;
+	}
+	uint64_t target = (uint64_t)(percent / 100.0 * count + 0.5);
+	target = target < 1 ? 1 : (target > count ? count : target);
+	uint64_t seen = 0;
+	for (unsigned int i = 0; i < bucketCount; i++) {
+		seen += counts[i];
+		if (seen >= target) {
+			uint64_t value = highestEquivalent(i);
+			return value < max ? value : max;
+		}
+	}
+	return max;
+}
+
+void LatencyHistogram::print(std::ostream& out, const char* name) const {
+	out << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(1);
+	if (!count) {
+		out << "no samples" << std::endl;
+		return;
+	}
+	out << std::setw(8) << count
+		<< std::setw(10) << toMicroseconds(min)
+		<< std::setw(10) << toMicroseconds(percentile(50.0))
+		<< std::setw(10) << toMicroseconds(percentile(90.0))
+		<< std::setw(10) << toMicroseconds(percentile(99.0))
+		<< std::setw(10) << toMicroseconds(percentile(99.9))
+		<< std::setw(10) << toMicroseconds(max)
+		<< std::setw(10) << toMicroseconds((uint64_t)(total / count)) << std::endl;
+}
+
+void LatencyHistogram::writeDistribution(std::ostream& out) const {
+	out << "#value_us\tpercentile\tcount" << std::endl;
+	uint64_t seen = 0;
+	for (unsigned int i = 0; i < bucketCount; i++) {
+		if (!counts[i]) {
+			continue;
+		}
+		seen += counts[i];
+		uint64_t value = highestEquivalent(i);
+		out << toMicroseconds(value < max ? value : max) << "\t" << (double)seen / count << "\t" << seen << std::endl;
+	}
+}
+
+/*
+	TRACKER
+*/
+
+LatencyTracker::LatencyTracker(double probeInterval)
+	: probeInterval(probeInterval), probes(0), pending(false), probing(false),
+	nextProbe(simClock::now() + std::chrono::duration_cast<simClock::duration>(std::chrono::duration<double>(probeInterval))) {}
+
+//one probe in flight at a time, a probe that never shows up is dropped at the next interval
+void LatencyTracker::inject(SimThread& simThread) {
+	simClock::time_point now = simClock::now();
+	if (probing || now < nextProbe) {
+		return;
+	}
+	const unsigned char bits[2] = { INPUT_LEFT_UP, INPUT_LEFT_DOWN };
+	injected = simThread.keyEvent(bits[(probes / 2) % 2], probes % 2 == 0);
+	probes++;
+	pending = true;
+	nextProbe = now + std::chrono::duration_cast<simClock::duration>(std::chrono::duration<double>(probeInterval));
+}
+
+void LatencyTracker::frameRead(const RenderSnapshot& snapshot) {
+	if (!pending || snapshot.inputTime < injected) {
+		return;
+	}
+	pending = false;
+	probing = true;
+	stamps[LATENCY_SIM] = snapshot.publishTime;
+	stamps[LATENCY_PICKUP] = simClock::now();
+}
+
+void LatencyTracker::mark(LatencyStage stage) {
+	if (probing) {
+		stamps[stage] = simClock::now();
+	}
+}
+
+void LatencyTracker::frameSwapped() {
+	if (!probing) {
+		return;
+	}
+	stamps[LATENCY_SWAP] = simClock::now();
+
+	//flush on the first wait so the fence is guaranteed to reach the gpu
+	GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+	GLenum result;
+	do {
+		result = glClientWaitSync(fence, flags, 100 * 1000 * 1000);
+		flags = 0;
+	} while (result == GL_TIMEOUT_EXPIRED);
+	stamps[LATENCY_GPU] = simClock::now();
+	glDeleteSync(fence);
+	probing = false;
+
+	if (result == GL_WAIT_FAILED) {
+		return;
+	}
+	simClock::time_point previous = injected;
+	for (unsigned int stage = LATENCY_SIM; stage <= LATENCY_GPU; stage++) {
+		stages[stage].record(nanosecondsBetween(previous, stamps[stage]));
+		previous = stamps[stage];
+	}
+	stages[LATENCY_TOTAL].record(nanosecondsBetween(injected, stamps[LATENCY_GPU]));
+}
+
+void LatencyTracker::print(std::ostream& out) const {
+	out << "latency (us)    samples       min       p50       p90       p99     p99.9       max      mean" << std::endl;
+	for (unsigned int stage = 0; stage < LATENCY_STAGE_COUNT; stage++) {
+		stages[stage].print(out, latencyStageName((LatencyStage)stage));
+	}
+}
+
+bool LatencyTracker::writeDistribution(const char* filename) const {
+	std::ofstream file(filename);
+	if (!file) {
+		std::cout << "Could not write " << filename << std::endl;
+		return false;
+	}
+	for (unsigned int stage = 0; stage < LATENCY_STAGE_COUNT; stage++) {
+		file << "# " << latencyStageName((LatencyStage)stage) << std::endl;
+		stages[stage].writeDistribution(file);
+	}
+	return true;
+}
@@ -0,0 +1,102 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include "simThread.hpp"
+
+/*
+	log linear histogram in the style of HdrHistogram, values in nanoseconds
+
+	values below 128 get a bucket each, above that every power of two is split
+	into 64 linear buckets, so anything recorded comes back within 1/64 of what
+	it was. recording is a couple of shifts, the whole 64 bit range fits.
+*/
+class LatencyHistogram {
+public:
+	uint64_t count;
+	uint64_t min;
+	uint64_t max;
+	double total;
+
+	LatencyHistogram();
+
+	void record(uint64_t value);
+
+	//highest value of the bucket the percentile lands in, 0 when empty
+	uint64_t percentile(double percent) const;
+
+	//one summary line, times in microseconds
+	void print(std::ostream& out, const char* name) const;
+	//value/percentile/count table per filled bucket, for plotting
+	void writeDistribution(std::ostream& out) const;
+
+private:
+	static const unsigned int subBucketBits = 7;
+	static const unsigned int subBucketCount = 1 << subBucketBits;
+	static const unsigned int subBucketHalf = subBucketCount / 2;
+	static const unsigned int bucketCount = subBucketCount + (64 - subBucketBits) * subBucketHalf;
+
+	std::vector<uint64_t> counts;
+
+	static unsigned int indexOf(uint64_t value);
+	static uint64_t highestEquivalent(unsigned int index);
+};
+
+enum LatencyStage {
+	LATENCY_SIM,		//input event to the snapshot of the tick that consumed it
+	LATENCY_PICKUP,		//snapshot published to the render thread reading it
+	LATENCY_UPLOAD,		//read to buffer uploads done
+	LATENCY_SUBMIT,		//uploads to draw calls issued
+	LATENCY_SWAP,		//draws to glfwSwapBuffers returning
+	LATENCY_GPU,		//swap return to the fence after it signalling
+	LATENCY_TOTAL,		//input event to gpu done
+	LATENCY_STAGE_COUNT
+};
+
+/*
+	input to photon latency, stage by stage (--latency)
+
+	every probe interval the tracker injects a key event into the sim thread's
+	queue, cycling press/release of left up and left down. the first frame that
+	reads a snapshot whose tick consumed it is timed through upload, submit and
+	swap, then a fence placed after the swap is waited on for gpu completion.
+	only probed frames wait on the fence, the frames in between run as usual.
+	scanout after the gpu is done is out of reach from here.
+
+	only core 3.3 calls are used so it runs under mesa llvmpipe
+	(LIBGL_ALWAYS_SOFTWARE=1) on a box without a gpu.
+*/
+class LatencyTracker {
+public:
+	LatencyHistogram stages[LATENCY_STAGE_COUNT];
+	double probeInterval;
+
+	LatencyTracker(double probeInterval = 0.25);
+
+	//render thread, once per frame before reading the snapshot
+	void inject(SimThread& simThread);
+	//right after reading it, starts timing the frame if it carries the probe
+	void frameRead(const RenderSnapshot& snapshot);
+	//end of LATENCY_UPLOAD or LATENCY_SUBMIT
+	void mark(LatencyStage stage);
+	//right after the swap, waits for the gpu and records the probe
+	void frameSwapped();
+
+	void print(std::ostream& out) const;
+	bool writeDistribution(const char* filename) const;
+
+private:
+	unsigned int probes;
+	bool pending;
+	bool probing;
+	simClock::time_point injected;
+	simClock::time_point nextProbe;
+	simClock::time_point stamps[LATENCY_STAGE_COUNT];
+};
+
+const char* latencyStageName(LatencyStage stage);
+
+#endif
@@ -1,8 +1,29 @@
 #include <string>
 #include <sstream>
 #include <fstream>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <vector>
+#include <chrono>
+#include <thread>
 #include "main.hpp"
+#include "benchGL.hpp"
+#include "headless.hpp"
+#include "latency.hpp"
+#include "multiBall.hpp"
+#include "paddleAI.hpp"
+#include "pongBatch.hpp"
+#include "sceneBatch.hpp"
+#include "glExt.hpp"
+#include "replay.hpp"
+#include "net.hpp"
+#include "shmTransport.hpp"
+#include "simThread.hpp"
 #include "shader.hpp"
+#include "shaderCache.hpp"
+#include "shaderVariants.hpp"
+#include "viewUniforms.hpp"
 #include "VAO.hpp"
 #include "VBO.hpp"
 #include "EBO.hpp"
@@ -30,7 +51,7 @@ void initGLFW(unsigned int versionMajor, unsigned int versionMinor) {
 	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
 #endif
 
-	glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+	glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
 }
 
 //create window
@@ -44,9 +65,11 @@ void createWindow(GLFWwindow*& window, const char* title, unsigned int width, un
 	glfwSetFramebufferSizeCallback(window, framebufferSizeCallback);
 }
 
-// callback window size change
+// callback window size change, the main loop applies it before the next draw
 void framebufferSizeCallback(GLFWwindow* window, int width, int height) {
-	glViewport(0, 0, screenWidth, screenHeight);
+	framebufferWidth = width;
+	framebufferHeight = height;
+	framebufferResized = true;
 }
 
 //load glad library
@@ -54,104 +77,45 @@ bool loadGlad() {
 	return gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
 }
 
-/*
-	shader methods
-*/
-
-//set projection
-void setOrthographicProjection(Shader shader,
-	float left, float right,
-	float bottom, float top,
-	float near, float far) {
-	/*float mat[4][4] = {
-		{2.0f / (right - left), 0.0f, 0.0f, -(right + left) / (right - left)},
-		{0.0f, 2.0f / (top - bottom), 0.0f, -(top + bottom) / (top - bottom)},
-		{0.0f, 0.0f, -2.0f / (far - near), -(far + near) / (far - near)},
-		{0.0f, 0.0f, 0.0f, 1.0f}
-	};*/
-	float mat[4][4] = {
-		{ 2.0f / (right - left), 0.0f, 0.0f, 0.0f },
-		{ 0.0f, 2.0f / (top - bottom), 0.0f, 0.0f },
-		{ 0.0f, 0.0f, -2.0f / (far - near), 0.0f },
-		{ -(right + left) / (right - left), -(top + bottom) / (top - bottom), -(far + near) / (far - near), 1.0f }
-	};
-
-	shader.Activate();
-	glUniformMatrix4fv(glGetUniformLocation(shader.shaderObj, "projection"), 1, GL_FALSE, &mat[0][0]);
-}
-
 /*
 	Vertex Array Object/Buffer Object Methods
 */
 
-void updateData(VBO& bo, GLintptr offset, GLuint numElements, GLfloat* data) {
-	bo.Bind();
-	glBufferSubData(GL_ARRAY_BUFFER, offset, numElements * sizeof(GLfloat), data);
-}
-
 //draw VAO
-void draw(VAO vao, GLenum mode, GLuint count, GLenum type, GLint indices, GLuint instanceCount) {
+void draw(const VAO& vao, GLenum mode, GLuint count, GLenum type, GLint indices, GLuint instanceCount) {
 	vao.Bind();
 	glDrawElementsInstanced(mode, count, type, (void*)indices, instanceCount);
 }
 
-//method to generate arrays for circle model
-void gen2DCircleArray(GLfloat*& vertices, GLuint*& indices, unsigned int numTriangles, GLfloat radius = 0.5f) {
-	vertices = new GLfloat[(numTriangles + 1) * 2];
-	vertices[0] = 0.0f;
-	vertices[1] = 0.0f;
-
-	indices = new GLuint[numTriangles * 3];
-
-	float numTrianglesF = (float)numTriangles;
-	GLfloat theta = 0.0f;
-
-	for (GLuint i = 0; i < numTriangles; i++) {
-		vertices[(i + 1) * 2] = radius * cosf(theta);
-		vertices[(i + 1) * 2 + 1] = radius * sinf(theta);
-
-		indices[i * 3 + 0] = 0;
-		indices[i * 3 + 1] = i + 1;
-		indices[i * 3 + 2] = i + 2;
-
-		theta += (2 * pi) / numTriangles;
-	}
-
-	indices[(numTriangles - 1) * 3 + 2] = 1;
-}
-
 /*
 	main loop methods
 */
 
-//process input
-void processPaddleInput(GLFWwindow* window, double dt, float* paddleOffset) {
-	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS) {
-		glfwSetWindowShouldClose(window, true);
+//keys go to the sim thread as timestamped events instead of being polled once a frame
+void keyCallback(GLFWwindow* window, int key, int /*scancode*/, int action, int /*mods*/) {
+	if (action == GLFW_REPEAT) {
+		return;
 	}
-
-	paddleVelocities[0] = 0.0f;
-	paddleVelocities[1] = 0.0f;
-
-	if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS) {
-		if (paddleOffset[3] < screenHeight - paddleBoundary) {
-			paddleVelocities[1] = paddleSpeed;
-		}
+	if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS) {
+		glfwSetWindowShouldClose(window, true);
+		return;
 	}
-	if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS) {
-		if (paddleOffset[3] > paddleBoundary) {
-			paddleVelocities[1] = -paddleSpeed;
-		}
+	if (key == GLFW_KEY_F2 && action == GLFW_PRESS) {
+		showDistance = !showDistance;
+		return;
 	}
-	if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) {
-		if (paddleOffset[1] < screenHeight - paddleBoundary) {
-			paddleVelocities[0] = paddleSpeed;
-		}
+
+	unsigned char bit = 0;
+	switch (key) {
+	case GLFW_KEY_UP: bit = INPUT_RIGHT_UP; break;
+	case GLFW_KEY_DOWN: bit = INPUT_RIGHT_DOWN; break;
+	case GLFW_KEY_W: bit = INPUT_LEFT_UP; break;
+	case GLFW_KEY_S: bit = INPUT_LEFT_DOWN; break;
 	}
-	if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) {
-		if (paddleOffset[1] > paddleBoundary) {
-			paddleVelocities[0] = -paddleSpeed;
-		}
+
+	SimThread* simThread = (SimThread*)glfwGetWindowUserPointer(window);
+	if (bit && simThread) {
+		simThread->keyEvent(bit, action == GLFW_PRESS);
 	}
 }
 
@@ -161,9 +125,23 @@ void clearScreen() {
 	glClear(GL_COLOR_BUFFER_BIT);
 }
 
+//average issued/elided binds per frame over the last stretch of frames
+void printGLStats(const GLStateCounters& total, unsigned int frames) {
+	std::cout << "gl binds per frame (issued/elided):";
+	for (unsigned int call = 0; call < GLSTATE_CALL_COUNT; call++) {
+		std::cout << " " << glStateCallName((GLStateCall)call) << " "
+			<< (double)total.issued[call] / frames << "/" << (double)total.elided[call] / frames;
+	}
+	std::cout << std::endl;
+}
+
 // new frame
-void newFrame(GLFWwindow* window) {
+void newFrame(GLFWwindow* window, LatencyTracker* latency) {
 	glfwSwapBuffers(window);
+	if (latency) {
+		latency->frameSwapped();
+	}
+	glFlushDeletes();
 	glfwPollEvents();
 }
 
@@ -176,7 +154,76 @@ void cleanup() {
 	glfwTerminate();
 }
 
-int main() {
+int main(int argc, char** argv) {
+	unsigned int multiBallCount = 0;
+	const char* recordFile = NULL;
+	unsigned short netLocalPort = 0;
+	unsigned short netRemotePort = 0;
+	int netSide = 0;
+	bool aiOpponent = false;
+	double tickRate = simTickRate;
+	double frameRate = 0.0;
+	bool measureLatency = false;
+	const char* latencyFile = NULL;
+	const char* streamArg = NULL;
+	bool benchStream = false;
+	bool benchBalls = false;
+	bool glStats = false;
+	bool sdfBalls = true;
+
+	//command line, headless modes return straight away
+	int headlessExit = 0;
+	if (runHeadless(argc, argv, (float)screenWidth, (float)screenHeight, headlessExit)) {
+		return headlessExit;
+	}
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--ai") == 0) {
+			aiOpponent = true;
+		}
+		if (strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc) {
+			tickRate = atof(argv[++i]);
+			tickRate = tickRate > 0.0 ? tickRate : simTickRate;
+		}
+		if (strcmp(argv[i], "--bench-stream") == 0) {
+			benchStream = true;
+		}
+		if (strcmp(argv[i], "--bench-balls") == 0) {
+			benchBalls = true;
+		}
+		if (strcmp(argv[i], "--ball-mesh") == 0 && i + 1 < argc) {
+			sdfBalls = strcmp(argv[++i], "fan") != 0;
+		}
+		if (strcmp(argv[i], "--no-shader-cache") == 0) {
+			shaderCacheDir = NULL;
+		}
+		if (strcmp(argv[i], "--gl-stats") == 0) {
+			glStats = true;
+		}
+		if (strcmp(argv[i], "--stream") == 0 && i + 1 < argc) {
+			streamArg = argv[++i];
+		}
+		if (strcmp(argv[i], "--latency") == 0) {
+			measureLatency = true;
+			if (i + 1 < argc && strncmp(argv[i + 1], "--", 2) != 0) {
+				latencyFile = argv[++i];
+			}
+		}
+		if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+			frameRate = atof(argv[++i]);
+		}
+		if (strcmp(argv[i], "--netplay") == 0 && i + 3 < argc) {
+			netLocalPort = (unsigned short)atoi(argv[++i]);
+			netRemotePort = (unsigned short)atoi(argv[++i]);
+			netSide = atoi(argv[++i]);
+		}
+		if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+			recordFile = argv[++i];
+		}
+		if (strcmp(argv[i], "--multiball") == 0 && i + 1 < argc) {
+			multiBallCount = (unsigned int)atoi(argv[++i]);
+		}
+	}
+
 	std::cout << "Initializing Window" << std::endl;
 
 	//timing
@@ -185,6 +232,9 @@ int main() {
 
 	//initialization
 	initGLFW(3, 3);
+	if (benchStream || benchBalls) {
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	}
 
 	//create window
 	GLFWwindow* window = nullptr;
@@ -202,12 +252,42 @@ int main() {
 		return -1;
 	}
 
-	glViewport(0, 0, screenWidth, screenHeight);
+	loadGLExtensions();
+
+	//one program per feature set, the one needed first goes to the driver now so the setup below overlaps its compile
+	ShaderVariants* sceneShaders = new ShaderVariants(vert_string, frag_string);
+	uint64_t sceneFeatures = sdfBalls ? (uint64_t)SHADER_SDF_EDGES : 0;
+	sceneShaders->prefetch(sceneFeatures);
 
-	//shaders
-	Shader shader(vert_string, frag_string);
-	shader.Activate();
-	setOrthographicProjection(shader, 0, screenWidth, 0, screenHeight, 0.0f, 1.0f);
+	//how per frame instance data gets to the gpu, --stream to compare the fallbacks
+	StreamMode streamMode = bestStreamMode();
+	if (streamArg && !parseStreamMode(streamArg, streamMode)) {
+		std::cout << "Unknown stream mode " << streamArg << ", using " << streamModeName(streamMode) << std::endl;
+	}
+
+	//projection and viewport for every program, rebuilt only when the framebuffer changes
+	ViewUniforms view((GLfloat)screenWidth, (GLfloat)screenHeight);
+	glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+	view.resize(framebufferWidth, framebufferHeight);
+	framebufferResized = false;
+
+	//the shader fades shape edges out through alpha
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	if (benchStream || benchBalls) {
+		sceneShaders->get(SHADER_SDF_EDGES).Activate();
+		if (benchStream) {
+			benchStreamUpload(window, (float)screenWidth, (float)screenHeight);
+		}
+		if (benchBalls) {
+			benchBallMeshes(window, (float)screenWidth, (float)screenHeight, streamMode);
+		}
+		delete sceneShaders;
+		glFlushDeletes();
+		cleanup();
+		return 0;
+	}
 
 	/*
 		PADDLE SETUP
@@ -227,200 +307,201 @@ int main() {
 		2, 3, 0
 	};
 
-	//offsets array
-	GLfloat paddleOffsets[] = {
-		35.0f, screenHeight / 2.0f,
-		screenWidth - 35.0f, screenHeight / 2.0f
-	};
-
-	GLfloat paddleSizes[] = {
-		paddleWidth, paddleHeight
-	};
-
-	paddleVelocities[0] = 0.0f;
-	paddleVelocities[1] = 0.0f;
-
-	VAO paddleVAO;
-	paddleVAO.Bind();
-
-	VBO paddlePosVBO(paddleVertices, sizeof(paddleVertices), GL_STATIC_DRAW);
-	paddleVAO.LinkAttri(paddlePosVBO, 0, 2, GL_FLOAT, 2 * sizeof(GLfloat), 0);
-
-	VBO paddleOffsetVBO(paddleOffsets, sizeof(paddleOffsets), GL_DYNAMIC_DRAW);
-	paddleVAO.LinkAttri(paddleOffsetVBO, 1, 2, GL_FLOAT, 2 * sizeof(GLfloat), 0, 1);
+	PongSim sim((float)screenWidth, (float)screenHeight, tickRate);
+
+	//online play, this window drives one paddle and the other comes over udp
+	RollbackSession* session = NULL;
+	NetplayPeer* peer = NULL;
+	if (netLocalPort) {
+		session = new RollbackSession(sim, netSide);
+		peer = new NetplayPeer(*session, netLocalPort, netRemotePort);
+		if (!peer->isOpen()) {
+			delete sceneShaders;
+			glFlushDeletes();
+			cleanup();
+			return -1;
+		}
+	}
 
-	VBO paddleSizeVBO(paddleSizes, sizeof(paddleSizes), GL_STATIC_DRAW);
-	paddleVAO.LinkAttri(paddleSizeVBO, 2, 2, GL_FLOAT, 2 * sizeof(GLfloat), 0, 2);
+	//cpu plays the right paddle, offline only
+	PaddleAI* ai = NULL;
+	if (aiOpponent && !peer) {
+		ai = new PaddleAI(1);
+	}
 
-	EBO paddleIndEBO(paddleIndices, sizeof(paddleIndices), GL_STATIC_DRAW);
+	ReplayWriter* recorder = NULL;
+	if (recordFile) {
+		recorder = new ReplayWriter(recordFile, sim);
+		sim.tickCallback = ReplayWriter::onTick;
+		sim.tickUser = recorder;
+	}
 
-	paddleVAO.Unbind();
-	paddlePosVBO.Unbind();
-	paddleOffsetVBO.Unbind();
-	paddleSizeVBO.Unbind();
-	paddleIndEBO.Unbind();
+	//paddles never move sideways, read it before the sim goes to its thread
+	const GLfloat paddleX[2] = { toFloat(sim.paddleX(0)), toFloat(sim.paddleX(1)) };
 
 	/*
 		BALL SETUP
 	*/
 
-	GLfloat* ballVertices;
-	GLuint* ballIndices;
+	//a quad the shader cuts a circle out of, --ball-mesh fan for the old triangle fan
+	std::vector<GLfloat> fanVertices;
+	std::vector<GLuint> fanIndices;
 	GLuint numTriangles = 20;
+	gen2DCircleArray(fanVertices, fanIndices, numTriangles, 0.5f);
+	GLfloat ballSize = ballDiameter;
 
-	gen2DCircleArray(ballVertices, ballIndices, numTriangles, 0.5f);
-
-	GLfloat ballOffset[] = {
-		screenWidth / 2.0f, screenHeight / 2.0f
-	};
-
-	GLfloat ballSize[] = {
-		ballDiameter, ballDiameter
-	};
-
-	VAO ballVAO;
-	ballVAO.Bind();
-
-	VBO ballPosVBO(ballVertices, (2 * (numTriangles + 1)) * sizeof(GLfloat), GL_STATIC_DRAW);
-	ballVAO.LinkAttri(ballPosVBO, 0, 2, GL_FLOAT, 2 * sizeof(GLfloat), 0);
-
-	VBO ballOffsetVBO(ballOffset, sizeof(ballOffset), GL_DYNAMIC_DRAW);
-	ballVAO.LinkAttri(ballOffsetVBO, 1, 2, GL_FLOAT, 2 * sizeof(GLfloat), 0, 1);
+	/*
+		PARTY MODE SETUP
+	*/
 
-	VBO ballSizeVBO(ballSize, sizeof(ballSize), GL_STATIC_DRAW);
-	ballVAO.LinkAttri(ballSizeVBO, 2, 2, GL_FLOAT, 2 * sizeof(GLfloat), 0, 1);
+	MultiBall* party = NULL;
+	if (multiBallCount > 0) {
+		//shrink the balls once they would cover more than a fifth of the field
+		float radius = sqrtf(0.2f * screenWidth * screenHeight / (multiBallCount * (float)pi));
+		party = new MultiBall(multiBallCount, (float)screenWidth, (float)screenHeight, radius < ballRadius ? radius : ballRadius);
+		ballSize = 2.0f * party->radius;
+	}
 
-	EBO ballIndEBO(ballIndices, (3 * numTriangles) * sizeof(GLfloat), GL_STATIC_DRAW);
+	/*
+		SCENE SETUP
+	*/
 
-	ballVAO.Unbind();
-	ballPosVBO.Unbind();
-	ballOffsetVBO.Unbind();
-	ballSizeVBO.Unbind();
-	ballIndEBO.Unbind();
+	//every mesh shares one vao and one set of buffers, a frame goes out in one draw call
+	SceneBatch scene(streamMode);
+	unsigned int paddleMesh = scene.addMesh(paddleVertices, 4, paddleIndices, 6);
+	unsigned int ballMesh = sdfBalls ? paddleMesh : scene.addMesh(fanVertices.data(), numTriangles + 1, fanIndices.data(), 3 * numTriangles);
+	GLfloat ballCorner = sdfBalls ? 0.5f * ballSize : 0.0f;
+	scene.uploadMeshes();
+
+	//by now the driver has had the whole setup to compile in, only what's left is waited on
+	sceneShaders->get(sceneFeatures).Activate();
+	//the debug view's variant compiles in the background, the frame loop picks it up
+	sceneShaders->prefetch(sceneFeatures | SHADER_SHOW_DISTANCE);
+
+	//simulation runs on its own thread from here on, only touch sim through snapshots
+	SimThread simThread(sim, peer, ai, party);
+	simThread.start();
+	glfwSetWindowUserPointer(window, &simThread);
+	glfwSetKeyCallback(window, keyCallback);
+
+	if (frameRate > 0) {
+		glfwSwapInterval(0);
+	}
+	double frameTime = frameRate > 0 ? 1.0 / frameRate : 0.0;
 
-	ballVelocity = initBallVelocity;
+	//input to photon instrumentation, injects its own key presses
+	LatencyTracker* latency = measureLatency ? new LatencyTracker() : NULL;
 
-	unsigned int framesSinceLastCollision = -1;
-	unsigned int framesThreshold = 10;
+	//setup binds don't count towards the first frame
+	glStateEndFrame();
+	GLStateCounters statsTotal = GLStateCounters();
+	unsigned int statsFrames = 0;
+	double statsStart = glfwGetTime();
 
 	while (!glfwWindowShouldClose(window)) {
 		dt = glfwGetTime() - lastFrame;
 		lastFrame += dt;
 
-		//input
-		processPaddleInput(window, dt, paddleOffsets);
-
-		/*
-			physics
-		*/
-
-		if (framesSinceLastCollision != -1) {
-			framesSinceLastCollision++;
+		//newest state the sim thread has finished, blended with the tick before it
+		//so motion stays smooth when the display rate isn't a multiple of the tick rate
+		if (latency) {
+			latency->inject(simThread);
+		}
+		const RenderSnapshot& snapshot = simThread.snapshots.read();
+		if (latency) {
+			latency->frameRead(snapshot);
 		}
+		PongState shown = interpolateState(snapshot.previous, snapshot.state, snapshotAlpha(snapshot, simClock::now()));
 
-		paddleOffsets[1] += paddleVelocities[0] * dt;
-		paddleOffsets[3] += paddleVelocities[1] * dt;
+		if (framebufferResized) {
+			framebufferResized = false;
+			view.resize(framebufferWidth, framebufferHeight);
+		}
 
-		//update position
-		ballOffset[0] += ballVelocity.x * dt;
-		ballOffset[1] += ballVelocity.y * dt;
+		clearScreen();
 
-		/*
-			collision
-		*/
+		unsigned int ballCount = party ? snapshot.partyCount : 1;
+		scene.begin(2 + ballCount);
 
-		// playing field
-		if (ballOffset[1] - ballRadius <= 0 || ballOffset[1] + ballRadius >= screenHeight) {
-			ballVelocity.y *= -1;
+		SceneInstance* paddles = scene.add(paddleMesh, 2);
+		SceneInstance* balls = scene.add(ballMesh, ballCount);
+		if (!paddles || !balls) {
+			//the instance stream couldn't be mapped (or had no room), skip this frame's draw
+			scene.cancel();
 		}
-
-		unsigned char reset = 0;
-		if (ballOffset[0] - ballRadius <= 0) {
-			std::cout << "Right player point" << std::endl;
-			reset = 1;
+		else {
+			for (unsigned int side = 0; side < 2; side++) {
+				paddles[side] = { { paddleX[side], toFloat(shown.paddleY[side]) }, { paddleWidth, paddleHeight }, { 255, 255, 255, 255 }, 0.0f };
+			}
+			if (party) {
+				const float* positions = snapshot.partyPositions.data();
+				for (unsigned int i = 0; i < ballCount; i++) {
+					balls[i] = { { positions[2 * i], positions[2 * i + 1] }, { ballSize, ballSize }, { 255, 255, 255, 255 }, ballCorner };
+				}
+			}
+			else {
+				balls[0] = { { toFloat(shown.ballX), toFloat(shown.ballY) }, { ballSize, ballSize }, { 255, 255, 255, 255 }, ballCorner };
+			}
 		}
-		else if (ballOffset[0] + ballRadius >= screenWidth) {
-			std::cout << "Left player point" << std::endl;
-			reset = 2;
+		if (latency) {
+			latency->mark(LATENCY_UPLOAD);
 		}
 
-		if (reset) {
-			ballOffset[0] = screenWidth / 2.0f;
-			ballOffset[1] = screenHeight / 2.0f;
-			ballVelocity.x = reset == 1 ? initBallVelocity.x : -initBallVelocity.x;
-			ballVelocity.y = initBallVelocity.y;
+		//a variant not used before compiles in the background, the plain one draws until it's done
+		sceneShaders->poll();
+		const Shader* variant = showDistance ? sceneShaders->ready(sceneFeatures | SHADER_SHOW_DISTANCE) : NULL;
+		(variant ? *variant : sceneShaders->get(sceneFeatures)).Activate();
+		scene.draw();
+		if (latency) {
+			latency->mark(LATENCY_SUBMIT);
 		}
 
+		newFrame(window, latency);
 
-		if (framesSinceLastCollision >= framesThreshold) {
-			/*
-			paddle collision
-		*/
-			int i = 0;
-			if (ballOffset[0] > screenHeight / 2.0f) {
-				//if ball on right side, check with right paddle
-				i++;
+		GLStateCounters frameCounters = glStateEndFrame();
+		if (glStats) {
+			for (unsigned int call = 0; call < GLSTATE_CALL_COUNT; call++) {
+				statsTotal.issued[call] += frameCounters.issued[call];
+				statsTotal.elided[call] += frameCounters.elided[call];
 			}
+			statsFrames++;
+			if (glfwGetTime() - statsStart >= 1.0) {
+				printGLStats(statsTotal, statsFrames);
+				statsTotal = GLStateCounters();
+				statsFrames = 0;
+				statsStart = glfwGetTime();
+			}
+		}
 
-			//get distance from enter of ball to center of paddle
-			vec2 distance = { abs(ballOffset[0] - paddleOffsets[i * 2]), abs(ballOffset[1] - paddleOffsets[(i * 2) + 1]) };
-
-			//check if no collision possible
-			if (distance.x <= halfPaddleWidth + ballRadius &&
-				distance.y <= halfPaddleHeight + ballRadius) {
-				bool collision = false;
-				if (distance.x <= halfPaddleWidth && distance.x >= halfPaddleWidth - ballRadius) {
-					collision = true;
-					ballVelocity.x *= -1;
-				}
-				else if (distance.y <= halfPaddleHeight && distance.y >= halfPaddleHeight - ballRadius) {
-					collision = true;
-					ballVelocity.y *= -1;
-				}
-
-				float squaredistance = pow(distance.x - halfPaddleWidth, 2) + pow(distance.y - halfPaddleHeight, 2);
-				if (squaredistance <= pow(ballRadius, 2)) {
-					collision = true;
-					ballVelocity.x *= -1;
-				}
-
-				if (collision) {
-					float k = 0.5f;
-					ballVelocity.x += .01f;
-					ballVelocity.y += k * paddleVelocities[i];
-					framesSinceLastCollision = 0;
-				}
+		//render cap without vsync
+		if (frameTime > 0.0) {
+			double spare = lastFrame + frameTime - glfwGetTime();
+			if (spare > 0.0) {
+				std::this_thread::sleep_for(std::chrono::duration<double>(spare));
 			}
 		}
+	}
 
-		clearScreen();
+	glfwSetKeyCallback(window, NULL);
+	simThread.stop();
 
-		updateData(paddleOffsetVBO, 0, 4, paddleOffsets);
-		updateData(ballOffsetVBO, 0, 2, ballOffset);
-
-		shader.Activate();
-		paddleVAO.Bind();
-		//draw(paddleVAO, GL_TRIANGLES, 3 * 2, GL_UNSIGNED_INT, 0, 2);
-		glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, 2);
-		ballVAO.Bind();
-		glDrawElementsInstanced(GL_TRIANGLES, 3 * numTriangles, GL_UNSIGNED_INT, 0, 1);
-		
-		newFrame(window);
+	if (latency) {
+		latency->print(std::cout);
+		if (latencyFile) {
+			latency->writeDistribution(latencyFile);
+		}
+		delete latency;
 	}
 
-	paddleVAO.Delete();
-	paddlePosVBO.Delete();
-	paddleOffsetVBO.Delete();
-	paddleSizeVBO.Delete();
-	paddleIndEBO.Delete();
-
-	ballVAO.Delete();
-	ballPosVBO.Delete();
-	ballOffsetVBO.Delete();
-	ballSizeVBO.Delete();
-	ballIndEBO.Delete();
+	delete party;
+	delete ai;
+	delete recorder;
+	delete peer;
+	delete session;
+	delete sceneShaders;
 
-	shader.Delete();
+	//gl objects still alive here go with the context
+	glFlushDeletes();
 	cleanup();
 
 	return 0;
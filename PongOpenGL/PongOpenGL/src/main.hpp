@@ -2,21 +2,22 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include "VAO.hpp"
+#include "pongSim.hpp"
 #include <iostream>
 
+class LatencyTracker;
+
 unsigned int screenWidth = 800;
 unsigned int screenHeight = 600;
-const char* title = "Pong";
 
-//graphics parameters
-const float paddleSpeed = 250.0f;
-const float paddleHeight = 100.0f;
-const float halfPaddleHeight = paddleHeight / 2.0f;
-const float paddleWidth = 10.0f;
-const float halfPaddleWidth = paddleWidth / 2.0f;
-const float ballDiameter = 10.0f;
-const float ballRadius = ballDiameter / 2.0f;
-const float paddleBoundary = (paddleHeight / 2.0f) + (ballDiameter / 2.0f);
+//set by the framebuffer size callback, picked up by the main loop
+int framebufferWidth = 0;
+int framebufferHeight = 0;
+bool framebufferResized = false;
+
+//F2, draws the scene with the SHADER_SHOW_DISTANCE variant
+bool showDistance = false;
+const char* title = "Pong";
 
 const double pi = 3.14159265358979323846;
 //structure for VAO storing Array Object and its Buffer objects
@@ -28,16 +29,6 @@ const double pi = 3.14159265358979323846;
 //	GLuint EBO;
 //};
 
-struct vec2 {
-	GLfloat x;
-	GLfloat y;
-};
-
-//public vel
-float paddleVelocities[2];
-vec2 initBallVelocity = { 150.0f, 150.0f };
-vec2 ballVelocity;
-
 /*
 	initialization methods
 */
@@ -49,15 +40,15 @@ bool loadGlad();
 /*
 	Vertex Array Object/Buffer Object Methods
 */
-void updateData(VBO& bo, GLintptr offset, GLuint numElements, GLfloat* data);
-void draw(VAO vao, GLenum mode, GLuint count, GLenum type, GLint indices, GLuint instanceCount = 1);
+void draw(const VAO& vao, GLenum mode, GLuint count, GLenum type, GLint indices, GLuint instanceCount = 1);
 
 /*
 	main loop methods
 */
-void processPaddleInput(GLFWwindow* window, double dt, float* paddleOffset);
+void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
 void clearScreen();
-void newFrame(GLFWwindow* window);
+void printGLStats(const GLStateCounters& total, unsigned int frames);
+void newFrame(GLFWwindow* window, LatencyTracker* latency = NULL);
 
 /*
 	clean up methods
@@ -0,0 +1,186 @@
+#include "multiBall.hpp"
+#include <cmath>
+
+//small lcg so the setup is the same on every platform
+static float nextRandom(unsigned int& seed) {
+	seed = seed * 1664525u + 1013904223u;
+	return (seed >> 8) * (1.0f / 16777216.0f);
+}
+
+MultiBall::MultiBall(unsigned int count, float width, float height, float radius, unsigned int seed)
+	: count(count), width(width), height(height), radius(radius),
+	x(count), y(count), vx(count), vy(count), lastCollisions(0) {
+	cellSize = 2.0f * radius;
+	gridWidth = (unsigned int)ceilf(width / cellSize);
+	gridHeight = (unsigned int)ceilf(height / cellSize);
+	gridWidth = gridWidth ? gridWidth : 1;
+	gridHeight = gridHeight ? gridHeight : 1;
+
+	cellStart.resize(gridWidth * gridHeight + 1);
+	cellOf.resize(count);
+	cursor.resize(gridWidth * gridHeight);
+	scratch.resize(count);
+	scratchCells.resize(count);
+
+	const float speed = sqrtf(initBallVelocity.x * initBallVelocity.x + initBallVelocity.y * initBallVelocity.y);
+	for (unsigned int i = 0; i < count; i++) {
+		x[i] = radius + nextRandom(seed) * (width - 2.0f * radius);
+		y[i] = radius + nextRandom(seed) * (height - 2.0f * radius);
+		float theta = nextRandom(seed) * 2.0f * 3.14159265f;
+		vx[i] = speed * cosf(theta);
+		vy[i] = speed * sinf(theta);
+	}
+}
+
+unsigned int MultiBall::cellIndex(float px, float py) const {
+	int cx = (int)(px / cellSize);
+	int cy = (int)(py / cellSize);
+	cx = cx < 0 ? 0 : (cx >= (int)gridWidth ? gridWidth - 1 : cx);
+	cy = cy < 0 ? 0 : (cy >= (int)gridHeight ? gridHeight - 1 : cy);
+	return cy * gridWidth + cx;
+}
+
+void MultiBall::permute(std::vector<float>& values, const std::vector<unsigned int>& destination) {
+	for (unsigned int i = 0; i < count; i++) {
+		scratch[destination[i]] = values[i];
+	}
+	values.swap(scratch);
+}
+
+//counting sort of the balls into cells, balls in a cell end up next to each other
+void MultiBall::buildGrid() {
+	unsigned int numCells = gridWidth * gridHeight;
+	for (unsigned int c = 0; c <= numCells; c++) {
+		cellStart[c] = 0;
+	}
+
+	for (unsigned int i = 0; i < count; i++) {
+		cellOf[i] = cellIndex(x[i], y[i]);
+		cellStart[cellOf[i] + 1]++;
+	}
+
+	for (unsigned int c = 0; c < numCells; c++) {
+		cellStart[c + 1] += cellStart[c];
+		cursor[c] = cellStart[c];
+	}
+
+	for (unsigned int i = 0; i < count; i++) {
+		scratchCells[i] = cursor[cellOf[i]]++;
+	}
+
+	permute(x, scratchCells);
+	permute(y, scratchCells);
+	permute(vx, scratchCells);
+	permute(vy, scratchCells);
+}
+
+//narrowphase over the grid, each pair is visited once by only looking at half the neighbours
+unsigned int MultiBall::resolveCollisions() {
+	const float diameter = 2.0f * radius;
+	const float diameter2 = diameter * diameter;
+	const int forward[4][2] = { { 1, 0 }, { -1, 1 }, { 0, 1 }, { 1, 1 } };
+	unsigned int collisions = 0;
+
+	for (unsigned int cy = 0; cy < gridHeight; cy++) {
+		for (unsigned int cx = 0; cx < gridWidth; cx++) {
+			unsigned int c = cy * gridWidth + cx;
+			for (unsigned int i = cellStart[c]; i < cellStart[c + 1]; i++) {
+				for (int n = -1; n < 4; n++) {
+					unsigned int begin;
+					unsigned int end;
+					if (n < 0) {
+						//rest of this cell
+						begin = i + 1;
+						end = cellStart[c + 1];
+					}
+					else {
+						int nx = (int)cx + forward[n][0];
+						int ny = (int)cy + forward[n][1];
+						if (nx < 0 || nx >= (int)gridWidth || ny >= (int)gridHeight) {
+							continue;
+						}
+						unsigned int neighbour = ny * gridWidth + nx;
+						begin = cellStart[neighbour];
+						end = cellStart[neighbour + 1];
+					}
+
+					for (unsigned int j = begin; j < end; j++) {
+						float dx = x[j] - x[i];
+						float dy = y[j] - y[i];
+						float d2 = dx * dx + dy * dy;
+						if (d2 >= diameter2 || d2 <= 0.0f) {
+							continue;
+						}
+
+						//push apart evenly
+						float d = sqrtf(d2);
+						float normalX = dx / d;
+						float normalY = dy / d;
+						float push = 0.5f * (diameter - d);
+						x[i] -= normalX * push;
+						y[i] -= normalY * push;
+						x[j] += normalX * push;
+						y[j] += normalY * push;
+
+						//equal mass elastic, swap the normal components if closing
+						float closing = (vx[j] - vx[i]) * normalX + (vy[j] - vy[i]) * normalY;
+						if (closing < 0.0f) {
+							vx[i] += closing * normalX;
+							vy[i] += closing * normalY;
+							vx[j] -= closing * normalX;
+							vy[j] -= closing * normalY;
+						}
+						collisions++;
+					}
+				}
+			}
+		}
+	}
+
+	return collisions;
+}
+
+//move every ball, bounce off the field and paddles, then ball against ball
+void MultiBall::step(const float* paddleY, float dt) {
+	for (unsigned int i = 0; i < count; i++) {
+		float remaining = dt;
+
+		if (paddleY) {
+			for (int p = 0; p < 2; p++) {
+				SweepHit<float> hit;
+				float px = p == 0 ? paddleInset : width - paddleInset;
+				if (sweepCircleBox<float>(x[i], y[i], vx[i], vy[i], radius,
+					px, paddleY[p], halfPaddleWidth, halfPaddleHeight, remaining, hit)) {
+					x[i] += vx[i] * hit.t;
+					y[i] += vy[i] * hit.t;
+					remaining -= hit.t;
+					float vn = vx[i] * hit.nx + vy[i] * hit.ny;
+					vx[i] -= 2.0f * vn * hit.nx;
+					vy[i] -= 2.0f * vn * hit.ny;
+				}
+			}
+		}
+
+		x[i] += vx[i] * remaining;
+		y[i] += vy[i] * remaining;
+
+		//all four sides bounce in party mode
+		if ((x[i] - radius <= 0.0f && vx[i] < 0.0f) || (x[i] + radius >= width && vx[i] > 0.0f)) {
+			vx[i] = -vx[i];
+		}
+		if ((y[i] - radius <= 0.0f && vy[i] < 0.0f) || (y[i] + radius >= height && vy[i] > 0.0f)) {
+			vy[i] = -vy[i];
+		}
+	}
+
+	buildGrid();
+	lastCollisions = resolveCollisions();
+}
+
+//interleave into x, y pairs for the instance buffer
+void MultiBall::writePositions(float* positions) const {
+	for (unsigned int i = 0; i < count; i++) {
+		positions[i * 2] = x[i];
+		positions[i * 2 + 1] = y[i];
+	}
+}
@@ -0,0 +1,52 @@
+#ifndef MULTIBALL_H
+#define MULTIBALL_H
+
+#include <vector>
+#include "pongSim.hpp"
+
+/*
+	party mode, lots of balls bouncing off the walls, the paddles and each other
+
+	ball-ball pairs come from a uniform grid rebuilt every step with a counting
+	sort. the ball arrays are permuted into cell order as part of the sort so the
+	narrowphase walks memory front to back. every vector is sized in the
+	constructor, stepping never allocates.
+*/
+class MultiBall {
+public:
+	unsigned int count;
+	float width;
+	float height;
+	float radius;
+
+	std::vector<float> x;
+	std::vector<float> y;
+	std::vector<float> vx;
+	std::vector<float> vy;
+
+	//grid, cells are one diameter wide so only neighbouring cells can touch
+	float cellSize;
+	unsigned int gridWidth;
+	unsigned int gridHeight;
+	std::vector<unsigned int> cellStart;
+	std::vector<unsigned int> cellOf;
+
+	unsigned int lastCollisions;
+
+	MultiBall(unsigned int count, float width, float height, float radius = ballRadius, unsigned int seed = 1);
+
+	void step(const float* paddleY, float dt);
+	void buildGrid();
+	unsigned int resolveCollisions();
+	void writePositions(float* positions) const;
+
+private:
+	std::vector<float> scratch;
+	std::vector<unsigned int> scratchCells;
+	std::vector<unsigned int> cursor;
+
+	unsigned int cellIndex(float px, float py) const;
+	void permute(std::vector<float>& values, const std::vector<unsigned int>& destination);
+};
+
+#endif
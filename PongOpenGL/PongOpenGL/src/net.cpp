@@ -0,0 +1,169 @@
+#include "net.hpp"
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "Ws2_32.lib")
+const socketHandle invalidSocket = (socketHandle)INVALID_SOCKET;
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+const socketHandle invalidSocket = -1;
+#endif
+
+static sockaddr_in localhost(unsigned short port) {
+	sockaddr_in address;
+	memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	return address;
+}
+
+/*
+	SOCKET
+*/
+
+UdpSocket::UdpSocket() : handle(invalidSocket) {}
+
+UdpSocket::~UdpSocket() {
+	close();
+}
+
+//bind and go non blocking
+bool UdpSocket::open(unsigned short port) {
+#ifdef _WIN32
+	WSADATA wsa;
+	if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) {
+		std::cout << "Could not start winsock" << std::endl;
+		return false;
+	}
+#endif
+
+	handle = (socketHandle)socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (handle == invalidSocket) {
+		std::cout << "Could not create socket" << std::endl;
+		return false;
+	}
+
+	sockaddr_in address = localhost(port);
+	if (bind(handle, (sockaddr*)&address, sizeof(address)) != 0) {
+		std::cout << "Could not bind port " << port << std::endl;
+		close();
+		return false;
+	}
+
+#ifdef _WIN32
+	u_long nonBlocking = 1;
+	ioctlsocket(handle, FIONBIO, &nonBlocking);
+#else
+	fcntl(handle, F_SETFL, fcntl(handle, F_GETFL, 0) | O_NONBLOCK);
+#endif
+	return true;
+}
+
+bool UdpSocket::isOpen() const {
+	return handle != invalidSocket;
+}
+
+void UdpSocket::sendTo(unsigned short port, const void* data, int size) {
+	sockaddr_in address = localhost(port);
+	sendto(handle, (const char*)data, size, 0, (sockaddr*)&address, sizeof(address));
+}
+
+//bytes received, 0 or less when nothing is waiting
+int UdpSocket::receive(void* data, int size) {
+	return (int)recv(handle, (char*)data, size, 0);
+}
+
+void UdpSocket::close() {
+	if (handle == invalidSocket) {
+		return;
+	}
+#ifdef _WIN32
+	closesocket(handle);
+	WSACleanup();
+#else
+	::close(handle);
+#endif
+	handle = invalidSocket;
+}
+
+/*
+	PEER
+*/
+
+NetplayPeer::NetplayPeer(RollbackSession& session, unsigned short localPort, unsigned short remotePort)
+	: session(session), remotePort(remotePort), accumulator(0.0), remoteAck(session.currentTick()) {
+	socket.open(localPort);
+}
+
+bool NetplayPeer::isOpen() const {
+	return socket.isOpen();
+}
+
+//send the local inputs the remote is missing, oldest first. sent even with none so the ack gets through
+void NetplayPeer::send() {
+	unsigned int tick = session.currentTick();
+	unsigned int count = tick - remoteAck < inputRedundancy ? tick - remoteAck : inputRedundancy;
+
+	InputPacket packet;
+	packet.magic = inputPacketMagic;
+	packet.ackTick = session.confirmedTick;
+	packet.firstTick = remoteAck;
+	packet.count = (uint8_t)count;
+	for (unsigned int i = 0; i < count; i++) {
+		packet.buttons[i] = session.localInput(packet.firstTick + i);
+	}
+	socket.sendTo(remotePort, &packet, sizeof(packet));
+}
+
+//drain every waiting packet into the session, returns packets read
+unsigned int NetplayPeer::receive() {
+	unsigned int packets = 0;
+	InputPacket packet;
+	while (socket.receive(&packet, sizeof(packet)) == (int)sizeof(packet)) {
+		if (packet.magic != inputPacketMagic || packet.count > inputRedundancy) {
+			continue;
+		}
+		if (packet.ackTick > remoteAck && packet.ackTick <= session.currentTick()) {
+			remoteAck = packet.ackTick;
+		}
+		for (unsigned int i = 0; i < packet.count; i++) {
+			session.addRemoteInput(packet.firstTick + i, packet.buttons[i]);
+		}
+		packets++;
+	}
+	return packets;
+}
+
+//fixed timestep like PongSim::advance, but stalls when too far ahead of the remote player,
+//or when the remote is so far behind on our inputs that the oldest would leave the ring.
+//sends every update, even stalled, so a lost last packet gets resent
+unsigned int NetplayPeer::update(double frameDt, unsigned char localButtons) {
+	receive();
+
+	accumulator += frameDt > simMaxFrameTime ? simMaxFrameTime : frameDt;
+	unsigned int ticks = 0;
+	while (accumulator >= session.sim.tickDt && session.canAdvance()
+		&& session.currentTick() - remoteAck < rollbackWindow - 1) {
+		session.advance(localButtons);
+		accumulator -= session.sim.tickDt;
+		ticks++;
+	}
+	send();
+
+	//waiting on the remote, don't bank the time
+	bool stalled = !session.canAdvance() || session.currentTick() - remoteAck >= rollbackWindow - 1;
+	if (stalled && accumulator > session.sim.tickDt) {
+		accumulator = session.sim.tickDt;
+	}
+	session.applyCorrections();
+	return ticks;
+}
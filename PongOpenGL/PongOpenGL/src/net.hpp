@@ -0,0 +1,64 @@
+#ifndef NET_H
+#define NET_H
+
+#include <cstdint>
+#include "rollback.hpp"
+
+/*
+	localhost udp for netplay, both peers bind 127.0.0.1 on their own port
+*/
+
+#ifdef _WIN32
+typedef uintptr_t socketHandle;
+#else
+typedef int socketHandle;
+#endif
+
+class UdpSocket {
+public:
+	socketHandle handle;
+
+	UdpSocket();
+	~UdpSocket();
+	UdpSocket(const UdpSocket&) = delete;
+	UdpSocket& operator=(const UdpSocket&) = delete;
+
+	bool open(unsigned short port);
+	bool isOpen() const;
+	void sendTo(unsigned short port, const void* data, int size);
+	int receive(void* data, int size);
+	void close();
+};
+
+//every packet carries up to inputRedundancy local inputs starting at the first tick
+//the other side hasn't confirmed (its ackTick), so a lost packet costs nothing and
+//a peer stalled on the rollback window keeps resending exactly what's missing
+const unsigned int inputRedundancy = 8;
+const uint32_t inputPacketMagic = 0x504E4750;
+
+struct InputPacket {
+	uint32_t magic;
+	uint32_t ackTick;
+	uint32_t firstTick;
+	uint8_t count;
+	uint8_t buttons[inputRedundancy];
+};
+
+class NetplayPeer {
+public:
+	RollbackSession& session;
+	UdpSocket socket;
+	unsigned short remotePort;
+	double accumulator;
+	//first of our ticks the remote hasn't confirmed, from its packets
+	unsigned int remoteAck;
+
+	NetplayPeer(RollbackSession& session, unsigned short localPort, unsigned short remotePort);
+
+	bool isOpen() const;
+	void send();
+	unsigned int receive();
+	unsigned int update(double frameDt, unsigned char localButtons);
+};
+
+#endif
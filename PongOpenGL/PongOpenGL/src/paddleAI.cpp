@@ -0,0 +1,219 @@
+#include "paddleAI.hpp"
+#include "simd.hpp"
+#include <cmath>
+#include <cstring>
+#include <new>
+
+static unsigned int xorshift(unsigned int& state) {
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+//same bit trick as vsigned, [-1, 1)
+static float signedUnit(unsigned int bits) {
+	unsigned int mantissa = (bits >> 9) | 0x3F800000u;
+	float f;
+	memcpy(&f, &mantissa, sizeof(f));
+	return f * 2.0f - 3.0f;
+}
+
+/*
+	PREDICTION
+*/
+
+float paddleFaceX(int side, float width) {
+	float reach = halfPaddleWidth + ballRadius;
+	return side == 0 ? paddleInset + reach : width - paddleInset - reach;
+}
+
+//straight line on the unfolded strip, then fold back into the band
+float predictInterceptY(float x, float y, float vx, float vy, float targetX, float height) {
+	if (vx == 0.0f) {
+		return y;
+	}
+	float t = fmaxf((targetX - x) / vx, 0.0f);
+	float span = height - 2.0f * ballRadius;
+	float period = 2.0f * span;
+	float u = y - ballRadius + vy * t;
+	float m = u - period * floorf(u * (1.0f / period));
+	float folded = m <= span ? m : period - m;
+	return ballRadius + folded;
+}
+
+/*
+	SINGLE MATCH
+*/
+
+PaddleAI::PaddleAI(int side, float reactionDelay, float error, unsigned int seed)
+	: side(side), reactionDelay(reactionDelay), error(error),
+	target(0.0f), waiting(reactionDelay), rng(seed ? seed : 1) {}
+
+unsigned char PaddleAI::think(const PongSim& sim, float dt) {
+	const PongState& state = sim.state;
+	float width = toFloat(sim.width);
+	float height = toFloat(sim.height);
+	float vx = toFloat(state.ballVX);
+	bool approaching = side == 0 ? vx < 0.0f : vx > 0.0f;
+
+	//drift back to the middle until it has reacted to this volley
+	if (!approaching) {
+		target = height / 2.0f;
+		waiting = reactionDelay;
+	}
+	else if (waiting >= 0.0f) {
+		target = height / 2.0f;
+		waiting -= dt;
+		if (waiting < 0.0f) {
+			target = predictInterceptY(toFloat(state.ballX), toFloat(state.ballY), vx, toFloat(state.ballVY),
+				paddleFaceX(side, width), height) + error * signedUnit(xorshift(rng));
+			waiting = -1.0f;
+		}
+	}
+
+	//half a move of slack so it doesn't jitter around the target
+	float paddleY = toFloat(state.paddleY[side]);
+	float deadzone = paddleSpeed * dt * 0.5f;
+	unsigned char buttons = 0;
+	if (target > paddleY + deadzone) {
+		buttons |= side == 0 ? INPUT_LEFT_UP : INPUT_RIGHT_UP;
+	}
+	if (target < paddleY - deadzone) {
+		buttons |= side == 0 ? INPUT_LEFT_DOWN : INPUT_RIGHT_DOWN;
+	}
+	return buttons;
+}
+
+/*
+	BATCH
+*/
+
+BatchAI::BatchAI(const PongBatch& batch, int side, float reactionDelay, float error, unsigned int seed)
+	: side(side), reactionDelay(reactionDelay), error(error), capacity(batch.capacity) {
+	size_t floatArray = capacity * sizeof(float);
+	size_t intArray = capacity * sizeof(unsigned int);
+	memory = ::operator new(2 * floatArray + intArray, std::align_val_t(batchAlignment));
+
+	char* p = (char*)memory;
+	target = (float*)p; p += floatArray;
+	waiting = (float*)p; p += floatArray;
+	rng = (unsigned int*)p;
+
+	for (unsigned int i = 0; i < capacity; i++) {
+		rng[i] = (i + 1) * 2654435761u ^ seed;
+		rng[i] = rng[i] ? rng[i] : 1;
+	}
+	reset(batch);
+}
+
+BatchAI::~BatchAI() {
+	::operator delete(memory, std::align_val_t(batchAlignment));
+}
+
+void BatchAI::reset(const PongBatch& batch) {
+	for (unsigned int i = 0; i < capacity; i++) {
+		reset(batch, i);
+	}
+}
+
+void BatchAI::reset(const PongBatch& batch, unsigned int i) {
+	target[i] = batch.height / 2.0f;
+	waiting[i] = reactionDelay;
+}
+
+void BatchAI::predict(const PongBatch& batch, float* interceptY) const {
+	float faceX = paddleFaceX(side, batch.width);
+	for (unsigned int i = 0; i < capacity; i++) {
+		interceptY[i] = predictInterceptY(batch.ballX[i], batch.ballY[i], batch.ballVX[i], batch.ballVY[i], faceX, batch.height);
+	}
+}
+
+//reference path, same float operations in the same order as think()
+void BatchAI::thinkScalar(const PongBatch& batch, float dt, unsigned char* buttons) {
+	const unsigned char upBit = side == 0 ? INPUT_LEFT_UP : INPUT_RIGHT_UP;
+	const unsigned char downBit = side == 0 ? INPUT_LEFT_DOWN : INPUT_RIGHT_DOWN;
+	const float faceX = paddleFaceX(side, batch.width);
+	const float center = batch.height / 2.0f;
+	const float deadzone = paddleSpeed * dt * 0.5f;
+
+	for (unsigned int i = 0; i < capacity; i++) {
+		//every lane draws every tick so the stream matches the simd path
+		float noise = signedUnit(xorshift(rng[i])) * error;
+		float vx = batch.ballVX[i];
+		bool approaching = side == 0 ? vx < 0.0f : vx > 0.0f;
+		bool armed = waiting[i] >= 0.0f;
+		float next = waiting[i] - dt;
+		bool lock = approaching && armed && next < 0.0f;
+
+		if (lock) {
+			float predicted = predictInterceptY(batch.ballX[i], batch.ballY[i], vx, batch.ballVY[i], faceX, batch.height);
+			target[i] = predicted + noise;
+			waiting[i] = -1.0f;
+		}
+		else if (!approaching || armed) {
+			target[i] = center;
+			waiting[i] = approaching ? next : reactionDelay;
+		}
+
+		float diff = target[i] - batch.paddleY[side][i];
+		unsigned char bits = buttons[i] & ~(upBit | downBit);
+		bits |= diff > deadzone ? upBit : 0;
+		bits |= diff < -deadzone ? downBit : 0;
+		buttons[i] = bits;
+	}
+}
+
+void BatchAI::think(const PongBatch& batch, float dt, unsigned char* buttons) {
+#if defined(PONGBATCH_AVX2) || defined(PONGBATCH_SSE2)
+	const unsigned char upBit = side == 0 ? INPUT_LEFT_UP : INPUT_RIGHT_UP;
+	const unsigned char downBit = side == 0 ? INPUT_LEFT_DOWN : INPUT_RIGHT_DOWN;
+	const unsigned char keepBits = (unsigned char)~(upBit | downBit);
+	const vfloat zero = vset(0.0f);
+	const vfloat vdt = vset(dt);
+	const vfloat verror = vset(error);
+	const vfloat delay = vset(reactionDelay);
+	const vfloat locked = vset(-1.0f);
+	const vfloat faceX = vset(paddleFaceX(side, batch.width));
+	const vfloat center = vset(batch.height / 2.0f);
+	const vfloat deadzone = vset(paddleSpeed * dt * 0.5f);
+	const vfloat negDeadzone = vset(-(paddleSpeed * dt * 0.5f));
+	const vfloat radius = vset(ballRadius);
+	const vfloat span = vset(batch.height - 2.0f * ballRadius);
+	const vfloat period = vset(2.0f * (batch.height - 2.0f * ballRadius));
+	const vfloat invPeriod = vset(1.0f / (2.0f * (batch.height - 2.0f * ballRadius)));
+
+	for (unsigned int i = 0; i < capacity; i += simdWidth) {
+		vfloat noise = vmul(vsigned(vxorshift(rng + i)), verror);
+		vfloat x = vload(batch.ballX + i);
+		vfloat y = vload(batch.ballY + i);
+		vfloat vx = vload(batch.ballVX + i);
+		vfloat vy = vload(batch.ballVY + i);
+		vfloat approaching = side == 0 ? vlt(vx, zero) : vgt(vx, zero);
+
+		//predictInterceptY, a stopped ball stays where it is
+		vfloat t = vmax(vdiv(vsub(faceX, x), vx), zero);
+		vfloat u = vadd(vsub(y, radius), vmul(vy, t));
+		vfloat m = vsub(u, vmul(period, vfloor(vmul(u, invPeriod))));
+		vfloat folded = vselect(vle(m, span), m, vsub(period, m));
+		vfloat stopped = vandnot(vor(vlt(vx, zero), vgt(vx, zero)), vle(zero, zero));
+		vfloat predicted = vselect(stopped, y, vadd(radius, folded));
+
+		vfloat w = vload(waiting + i);
+		vfloat armed = vge(w, zero);
+		vfloat next = vsub(w, vdt);
+		vfloat lock = vand(vand(approaching, armed), vlt(next, zero));
+		vfloat keep = vandnot(armed, approaching);
+
+		vfloat aim = vselect(keep, vload(target + i), vselect(lock, vadd(predicted, noise), center));
+		vstore(target + i, aim);
+		vstore(waiting + i, vselect(approaching, vselect(armed, vselect(lock, locked, next), w), delay));
+
+		vfloat diff = vsub(aim, vload(batch.paddleY[side] + i));
+		vint bits = vori(vmaskbits(vgt(diff, deadzone), upBit), vmaskbits(vlt(diff, negDeadzone), downBit));
+		vstorebytes(buttons + i, bits, keepBits);
+	}
+#else
+	thinkScalar(batch, dt, buttons);
+#endif
+}
@@ -0,0 +1,74 @@
+#ifndef PADDLEAI_H
+#define PADDLEAI_H
+
+#include "pongSim.hpp"
+#include "pongBatch.hpp"
+
+/*
+	cpu opponent, no look ahead simulation
+
+	the walls are unfolded: between the two walls the ball's centre lives in a
+	band of height span = height - 2 * ballRadius, and a bounce is a mirror of
+	that band, so y keeps going in a straight line on a strip of period 2 * span.
+	the crossing at the paddle face is one divide and one floor. the prediction is
+	made once per volley, after the reaction delay, plus a random error, and the
+	paddle is driven towards it with the normal input bits.
+*/
+
+const float aiReactionDelay = 0.15f;
+const float aiError = 60.0f;
+
+float predictInterceptY(float x, float y, float vx, float vy, float targetX, float height);
+
+//x the ball's centre has when it touches paddle side's face
+float paddleFaceX(int side, float width);
+
+class PaddleAI {
+public:
+	int side;
+	float reactionDelay;
+	float error;
+
+	//where the paddle is heading, and seconds left before reacting (-1 once locked)
+	float target;
+	float waiting;
+	unsigned int rng;
+
+	PaddleAI(int side, float reactionDelay = aiReactionDelay, float error = aiError, unsigned int seed = 1);
+
+	//input bits for this side only, OR them into the other player's
+	unsigned char think(const PongSim& sim, float dt);
+};
+
+//the same controller for every match of a PongBatch at once
+class BatchAI {
+public:
+	int side;
+	float reactionDelay;
+	float error;
+	unsigned int capacity;
+
+	float* target;
+	float* waiting;
+	unsigned int* rng;
+
+	BatchAI(const PongBatch& batch, int side, float reactionDelay = aiReactionDelay, float error = aiError, unsigned int seed = 1);
+	~BatchAI();
+	BatchAI(const BatchAI&) = delete;
+	BatchAI& operator=(const BatchAI&) = delete;
+
+	void reset(const PongBatch& batch);
+	void reset(const PongBatch& batch, unsigned int i);
+
+	//intercept y of every match, ignoring delay and error
+	void predict(const PongBatch& batch, float* interceptY) const;
+
+	//replaces this side's bits in buttons (capacity entries), keeps the other side's
+	void think(const PongBatch& batch, float dt, unsigned char* buttons);
+	void thinkScalar(const PongBatch& batch, float dt, unsigned char* buttons);
+
+private:
+	void* memory;
+};
+
+#endif
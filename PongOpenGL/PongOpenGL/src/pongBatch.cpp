@@ -0,0 +1,283 @@
+#include "pongBatch.hpp"
+#include "simd.hpp"
+#include <cmath>
+#include <cstring>
+#include <new>
+
+//round up to the next multiple of the padding
+static unsigned int padCount(unsigned int count) {
+	return (count + batchPadding - 1) / batchPadding * batchPadding;
+}
+
+PongBatch::PongBatch(unsigned int count, float width, float height)
+	: count(count), capacity(padCount(count)), width(width), height(height) {
+	size_t floatArray = capacity * sizeof(float);
+	size_t intArray = capacity * sizeof(unsigned int);
+	size_t byteArray = capacity * sizeof(unsigned char);
+	size_t total = 6 * floatArray + 2 * intArray + byteArray;
+
+	memory = ::operator new(total, std::align_val_t(batchAlignment));
+	memset(memory, 0, total);
+
+	//carve every array out of the one block, each stays 64 byte aligned
+	char* p = (char*)memory;
+	ballX = (float*)p; p += floatArray;
+	ballY = (float*)p; p += floatArray;
+	ballVX = (float*)p; p += floatArray;
+	ballVY = (float*)p; p += floatArray;
+	paddleY[0] = (float*)p; p += floatArray;
+	paddleY[1] = (float*)p; p += floatArray;
+	scores[0] = (unsigned int*)p; p += intArray;
+	scores[1] = (unsigned int*)p; p += intArray;
+	points = (unsigned char*)p;
+
+	resetAll();
+}
+
+PongBatch::~PongBatch() {
+	::operator delete(memory, std::align_val_t(batchAlignment));
+}
+
+void PongBatch::reset(unsigned int i) {
+	ballX[i] = width / 2.0f;
+	ballY[i] = height / 2.0f;
+	ballVX[i] = initBallVelocity.x;
+	ballVY[i] = initBallVelocity.y;
+	paddleY[0][i] = height / 2.0f;
+	paddleY[1][i] = height / 2.0f;
+	scores[0][i] = 0;
+	scores[1][i] = 0;
+	points[i] = POINT_NONE;
+}
+
+void PongBatch::resetAll() {
+	for (unsigned int i = 0; i < capacity; i++) {
+		reset(i);
+	}
+}
+
+//copy one match out to the PongSim layout
+void PongBatch::getState(unsigned int i, PongState& state) const {
+	state.paddleY[0] = paddleY[0][i];
+	state.paddleY[1] = paddleY[1][i];
+	state.paddleVelocities[0] = 0.0f;
+	state.paddleVelocities[1] = 0.0f;
+	state.ballX = ballX[i];
+	state.ballY = ballY[i];
+	state.ballVX = ballVX[i];
+	state.ballVY = ballVY[i];
+	state.scores[0] = scores[0][i];
+	state.scores[1] = scores[1][i];
+	state.tick = 0;
+}
+
+void PongBatch::setState(unsigned int i, const PongState& state) {
+	paddleY[0][i] = toFloat(state.paddleY[0]);
+	paddleY[1][i] = toFloat(state.paddleY[1]);
+	ballX[i] = toFloat(state.ballX);
+	ballY[i] = toFloat(state.ballY);
+	ballVX[i] = toFloat(state.ballVX);
+	ballVY[i] = toFloat(state.ballVY);
+	scores[0][i] = state.scores[0];
+	scores[1][i] = state.scores[1];
+}
+
+/*
+	scalar reference, one match at a time
+*/
+void PongBatch::stepScalar(const unsigned char* buttons, float dt) {
+	stepScalar(buttons, dt, 0, capacity);
+}
+
+void PongBatch::stepScalar(const unsigned char* buttons, float dt, unsigned int begin, unsigned int end) {
+	const float top = height - paddleBoundary;
+	const float halfWidth = width / 2.0f;
+	const float leftX = paddleInset;
+	const float rightX = width - paddleInset;
+
+	for (unsigned int i = begin; i < end; i++) {
+		//paddles, down wins if both keys are held like PongSim
+		float velocities[2];
+		for (int p = 0; p < 2; p++) {
+			unsigned char up = p == 0 ? INPUT_LEFT_UP : INPUT_RIGHT_UP;
+			unsigned char down = p == 0 ? INPUT_LEFT_DOWN : INPUT_RIGHT_DOWN;
+			float v = 0.0f;
+			if ((buttons[i] & up) && paddleY[p][i] < top) {
+				v = paddleSpeed;
+			}
+			if ((buttons[i] & down) && paddleY[p][i] > paddleBoundary) {
+				v = -paddleSpeed;
+			}
+			velocities[p] = v;
+			paddleY[p][i] = paddleY[p][i] + v * dt;
+		}
+
+		float x = ballX[i] + ballVX[i] * dt;
+		float y = ballY[i] + ballVY[i] * dt;
+		float vx = ballVX[i];
+		float vy = ballVY[i];
+
+		//walls
+		if ((y - ballRadius <= 0.0f && vy < 0.0f) || (y + ballRadius >= height && vy > 0.0f)) {
+			vy = -vy;
+		}
+
+		//scoring
+		unsigned char point = POINT_NONE;
+		if (x - ballRadius <= 0.0f) {
+			point = POINT_RIGHT;
+			scores[1][i]++;
+		}
+		else if (x + ballRadius >= width) {
+			point = POINT_LEFT;
+			scores[0][i]++;
+		}
+		if (point) {
+			x = halfWidth;
+			y = height / 2.0f;
+			vx = point == POINT_RIGHT ? initBallVelocity.x : -initBallVelocity.x;
+			vy = initBallVelocity.y;
+		}
+		points[i] = point;
+
+		//paddle on the ball's half of the court
+		bool right = x > halfWidth;
+		float px = right ? rightX : leftX;
+		float py = right ? paddleY[1][i] : paddleY[0][i];
+		float pv = right ? velocities[1] : velocities[0];
+
+		float dx = fabsf(x - px);
+		float dy = fabsf(y - py);
+		float cx = fmaxf(dx - halfPaddleWidth, 0.0f);
+		float cy = fmaxf(dy - halfPaddleHeight, 0.0f);
+		bool overlap = cx * cx + cy * cy <= ballRadius * ballRadius;
+
+		bool approachX = right ? vx > 0.0f : vx < 0.0f;
+		bool approachY = (y - py) * vy < 0.0f;
+		bool hitX = overlap && dx > halfPaddleWidth && approachX;
+		bool hitY = overlap && dx <= halfPaddleWidth && approachY;
+
+		if (hitX) {
+			vx = -vx;
+		}
+		if (hitY) {
+			vy = -vy;
+		}
+		if (hitX || hitY) {
+			vx = vx + (vx < 0.0f ? -ballSpeedup : ballSpeedup);
+			vy = vy + paddleSpin * pv;
+		}
+
+		ballX[i] = x;
+		ballY[i] = y;
+		ballVX[i] = vx;
+		ballVY[i] = vy;
+	}
+}
+
+/*
+	simd kernel, every branch above becomes a mask and a select
+*/
+void PongBatch::step(const unsigned char* buttons, float dt) {
+	step(buttons, dt, 0, capacity);
+}
+
+void PongBatch::step(const unsigned char* buttons, float dt, unsigned int begin, unsigned int end) {
+#if defined(PONGBATCH_AVX2) || defined(PONGBATCH_SSE2)
+	const vfloat vdt = vset(dt);
+	const vfloat zero = vset(0.0f);
+	const vfloat signBit = vset(-0.0f);
+	const vfloat top = vset(height - paddleBoundary);
+	const vfloat bottom = vset(paddleBoundary);
+	const vfloat speed = vset(paddleSpeed);
+	const vfloat negSpeed = vset(-paddleSpeed);
+	const vfloat radius = vset(ballRadius);
+	const vfloat radius2 = vset(ballRadius * ballRadius);
+	const vfloat fieldWidth = vset(width);
+	const vfloat fieldHeight = vset(height);
+	const vfloat halfWidth = vset(width / 2.0f);
+	const vfloat halfHeight = vset(height / 2.0f);
+	const vfloat initVX = vset(initBallVelocity.x);
+	const vfloat initVY = vset(initBallVelocity.y);
+	const vfloat leftX = vset(paddleInset);
+	const vfloat rightX = vset(width - paddleInset);
+	const vfloat halfPW = vset(halfPaddleWidth);
+	const vfloat halfPH = vset(halfPaddleHeight);
+	const vfloat speedup = vset(ballSpeedup);
+	const vfloat spin = vset(paddleSpin);
+
+	for (unsigned int i = begin; i < end; i += simdWidth) {
+		//paddles
+		vfloat velocities[2];
+		for (int p = 0; p < 2; p++) {
+			unsigned char up = p == 0 ? INPUT_LEFT_UP : INPUT_RIGHT_UP;
+			unsigned char down = p == 0 ? INPUT_LEFT_DOWN : INPUT_RIGHT_DOWN;
+			vfloat py = vload(paddleY[p] + i);
+			vfloat upMask = vand(vbuttons(buttons + i, up), vlt(py, top));
+			vfloat downMask = vand(vbuttons(buttons + i, down), vgt(py, bottom));
+			vfloat v = vselect(downMask, negSpeed, vand(upMask, speed));
+			velocities[p] = v;
+			vstore(paddleY[p] + i, vadd(py, vmul(v, vdt)));
+		}
+
+		vfloat vx = vload(ballVX + i);
+		vfloat vy = vload(ballVY + i);
+		vfloat x = vadd(vload(ballX + i), vmul(vx, vdt));
+		vfloat y = vadd(vload(ballY + i), vmul(vy, vdt));
+
+		//walls
+		vfloat hitBottom = vand(vle(vsub(y, radius), zero), vlt(vy, zero));
+		vfloat hitTop = vand(vge(vadd(y, radius), fieldHeight), vgt(vy, zero));
+		vy = vxor(vy, vand(vor(hitBottom, hitTop), signBit));
+
+		//scoring
+		vfloat rightPoint = vle(vsub(x, radius), zero);
+		vfloat leftPoint = vandnot(rightPoint, vge(vadd(x, radius), fieldWidth));
+		vfloat scored = vor(rightPoint, leftPoint);
+		x = vselect(scored, halfWidth, x);
+		y = vselect(scored, halfHeight, y);
+		vx = vselect(rightPoint, initVX, vselect(leftPoint, vxor(initVX, signBit), vx));
+		vy = vselect(scored, initVY, vy);
+		vcount(scores[1] + i, rightPoint);
+		vcount(scores[0] + i, leftPoint);
+
+		int rightBits = vmovemask(rightPoint);
+		int leftBits = vmovemask(leftPoint);
+		for (unsigned int l = 0; l < simdWidth; l++) {
+			points[i + l] = (rightBits >> l) & 1 ? POINT_RIGHT : ((leftBits >> l) & 1 ? POINT_LEFT : POINT_NONE);
+		}
+
+		//paddle on the ball's half of the court
+		vfloat right = vgt(x, halfWidth);
+		vfloat px = vselect(right, rightX, leftX);
+		vfloat py = vselect(right, vload(paddleY[1] + i), vload(paddleY[0] + i));
+		vfloat pv = vselect(right, velocities[1], velocities[0]);
+
+		vfloat dx = vandnot(signBit, vsub(x, px));
+		vfloat dy = vandnot(signBit, vsub(y, py));
+		vfloat cx = vmax(vsub(dx, halfPW), zero);
+		vfloat cy = vmax(vsub(dy, halfPH), zero);
+		vfloat overlap = vle(vadd(vmul(cx, cx), vmul(cy, cy)), radius2);
+
+		vfloat approachX = vselect(right, vgt(vx, zero), vlt(vx, zero));
+		vfloat approachY = vlt(vmul(vsub(y, py), vy), zero);
+		vfloat outside = vgt(dx, halfPW);
+		vfloat hitX = vand(vand(overlap, outside), approachX);
+		vfloat hitY = vand(vandnot(outside, overlap), approachY);
+		vfloat hit = vor(hitX, hitY);
+
+		vx = vxor(vx, vand(hitX, signBit));
+		vy = vxor(vy, vand(hitY, signBit));
+		vfloat boost = vselect(vlt(vx, zero), vxor(speedup, signBit), speedup);
+		vx = vselect(hit, vadd(vx, boost), vx);
+		vy = vselect(hit, vadd(vy, vmul(spin, pv)), vy);
+
+		vstore(ballX + i, x);
+		vstore(ballY + i, y);
+		vstore(ballVX + i, vx);
+		vstore(ballVY + i, vy);
+	}
+#else
+	stepScalar(buttons, dt, begin, end);
+#endif
+}
@@ -0,0 +1,69 @@
+#ifndef PONGBATCH_H
+#define PONGBATCH_H
+
+#include "pongSim.hpp"
+
+/*
+	many independent matches stepped together, structure of arrays
+
+	every array is 64 byte aligned and padded to a multiple of simdWidth so the
+	kernel never needs a remainder loop. step() is the SIMD kernel, stepScalar()
+	is the reference path and does the same float operations in the same order
+	(build without fp contraction if the two are compared bit for bit).
+
+	collision is a discrete overlap test per tick (PongSim sweeps instead), a
+	bounce only happens while the ball is moving into the wall/paddle so the
+	kernel stays branch free
+*/
+
+#if defined(__AVX2__)
+#define PONGBATCH_AVX2
+const unsigned int simdWidth = 8;
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PONGBATCH_SSE2
+const unsigned int simdWidth = 4;
+#else
+const unsigned int simdWidth = 1;
+#endif
+
+const unsigned int batchAlignment = 64;
+const unsigned int batchPadding = 16;
+
+class PongBatch {
+public:
+	unsigned int count;
+	unsigned int capacity;
+	float width;
+	float height;
+
+	float* ballX;
+	float* ballY;
+	float* ballVX;
+	float* ballVY;
+	float* paddleY[2];
+	unsigned int* scores[2];
+	unsigned char* points;
+
+	PongBatch(unsigned int count, float width, float height);
+	~PongBatch();
+	PongBatch(const PongBatch&) = delete;
+	PongBatch& operator=(const PongBatch&) = delete;
+
+	void reset(unsigned int i);
+	void resetAll();
+	void getState(unsigned int i, PongState& state) const;
+	void setState(unsigned int i, const PongState& state);
+
+	//buttons holds capacity entries, one InputBits byte per match
+	void step(const unsigned char* buttons, float dt);
+	void stepScalar(const unsigned char* buttons, float dt);
+
+	//step only [begin, end), both multiples of batchPadding, for splitting across threads
+	void step(const unsigned char* buttons, float dt, unsigned int begin, unsigned int end);
+	void stepScalar(const unsigned char* buttons, float dt, unsigned int begin, unsigned int end);
+
+private:
+	void* memory;
+};
+
+#endif
@@ -0,0 +1,220 @@
+#include "pongSim.hpp"
+#include <cmath>
+
+PongSim::PongSim(float width, float height, double tickRate)
+	: width(width), height(height), tickDt(1.0 / tickRate), accumulator(0.0), tickCallback(nullptr), tickUser(nullptr) {
+	reset();
+}
+
+//put paddles and ball back to the start, clears scores
+void PongSim::reset() {
+	state.paddleY[0] = height / simfloat(2);
+	state.paddleY[1] = height / simfloat(2);
+	state.paddleVelocities[0] = 0.0f;
+	state.paddleVelocities[1] = 0.0f;
+	state.ballX = width / simfloat(2);
+	state.ballY = height / simfloat(2);
+	state.ballVX = initBallVelocity.x;
+	state.ballVY = initBallVelocity.y;
+	state.scores[0] = 0;
+	state.scores[1] = 0;
+	state.tick = 0;
+	accumulator = 0.0;
+	previous = state;
+}
+
+simfloat PongSim::paddleX(int i) const {
+	return i == 0 ? simfloat(paddleInset) : width - paddleInset;
+}
+
+//earliest contact of the ball with the walls or either paddle within maxT
+bool PongSim::sweepBall(simfloat maxT, Hit& hit) const {
+	const simfloat zero = simfloat(0);
+	bool found = false;
+	hit.t = maxT;
+
+	//playing field top and bottom
+	if (state.ballVY < zero) {
+		simfloat t = (ballRadius - state.ballY) / state.ballVY;
+		t = t < zero ? zero : t;
+		if (t <= hit.t) {
+			hit = { t, zero, simfloat(1), -1 };
+			found = true;
+		}
+	}
+	else if (state.ballVY > zero) {
+		simfloat t = (height - ballRadius - state.ballY) / state.ballVY;
+		t = t < zero ? zero : t;
+		if (t <= hit.t) {
+			hit = { t, zero, simfloat(-1), -1 };
+			found = true;
+		}
+	}
+
+	//both paddles, whichever comes first
+	for (int i = 0; i < 2; i++) {
+		Hit paddleHit;
+		if (sweepCircleBox<simfloat>(state.ballX, state.ballY, state.ballVX, state.ballVY, ballRadius,
+			paddleX(i), state.paddleY[i], halfPaddleWidth, halfPaddleHeight, hit.t, paddleHit)
+			&& (!found || paddleHit.t < hit.t)) {
+			hit = paddleHit;
+			hit.paddle = i;
+			found = true;
+		}
+	}
+
+	return found;
+}
+
+//advance one tick of length dt, returns which player scored (if any)
+unsigned char PongSim::step(const Inputs& inputs, double dt) {
+	simfloat sdt = simfloat(dt);
+	movePaddles(inputs.buttons, sdt);
+	return moveBall(sdt);
+}
+
+//same tick, but the buttons changed part way through it. the paddles move piece by
+//piece and keep the velocity of the last piece (for spin), then the ball runs the
+//whole tick against where they ended up
+unsigned char PongSim::step(const InputSegment* segments, unsigned int count, double dt) {
+	for (unsigned int i = 0; i < count; i++) {
+		movePaddles(segments[i].buttons, simfloat(segments[i].duration));
+	}
+	return moveBall(simfloat(dt));
+}
+
+void PongSim::movePaddles(unsigned char buttons, simfloat dt) {
+	state.paddleVelocities[0] = 0.0f;
+	state.paddleVelocities[1] = 0.0f;
+
+	if ((buttons & INPUT_RIGHT_UP) && state.paddleY[1] < height - paddleBoundary) {
+		state.paddleVelocities[1] = paddleSpeed;
+	}
+	if ((buttons & INPUT_RIGHT_DOWN) && state.paddleY[1] > paddleBoundary) {
+		state.paddleVelocities[1] = -paddleSpeed;
+	}
+	if ((buttons & INPUT_LEFT_UP) && state.paddleY[0] < height - paddleBoundary) {
+		state.paddleVelocities[0] = paddleSpeed;
+	}
+	if ((buttons & INPUT_LEFT_DOWN) && state.paddleY[0] > paddleBoundary) {
+		state.paddleVelocities[0] = -paddleSpeed;
+	}
+
+	state.paddleY[0] += state.paddleVelocities[0] * dt;
+	state.paddleY[1] += state.paddleVelocities[1] * dt;
+}
+
+//ball, swept against walls and paddles with a reflection at every contact
+unsigned char PongSim::moveBall(simfloat dt) {
+	simfloat remaining = dt;
+	for (unsigned int bounce = 0; bounce < maxBouncesPerStep && remaining > simfloat(0); bounce++) {
+		Hit hit;
+		if (!sweepBall(remaining, hit)) {
+			break;
+		}
+
+		state.ballX += state.ballVX * hit.t;
+		state.ballY += state.ballVY * hit.t;
+		remaining -= hit.t;
+
+		//reflect about the contact normal
+		simfloat vn = state.ballVX * hit.nx + state.ballVY * hit.ny;
+		state.ballVX -= simfloat(2) * vn * hit.nx;
+		state.ballVY -= simfloat(2) * vn * hit.ny;
+
+		if (hit.paddle >= 0) {
+			state.ballVX += state.ballVX < simfloat(0) ? -ballSpeedup : ballSpeedup;
+			state.ballVY += paddleSpin * state.paddleVelocities[hit.paddle];
+		}
+	}
+	state.ballX += state.ballVX * remaining;
+	state.ballY += state.ballVY * remaining;
+
+	/*
+		scoring
+	*/
+
+	unsigned char point = POINT_NONE;
+	if (state.ballX - ballRadius <= simfloat(0)) {
+		point = POINT_RIGHT;
+		state.scores[1]++;
+	}
+	else if (state.ballX + ballRadius >= width) {
+		point = POINT_LEFT;
+		state.scores[0]++;
+	}
+
+	if (point) {
+		state.ballX = width / simfloat(2);
+		state.ballY = height / simfloat(2);
+		state.ballVX = point == POINT_RIGHT ? initBallVelocity.x : -initBallVelocity.x;
+		state.ballVY = initBallVelocity.y;
+	}
+
+	state.tick++;
+	return point;
+}
+
+//fixed timestep accumulator, runs however many whole ticks fit in the frame
+unsigned int PongSim::advance(const Inputs& inputs, double frameDt) {
+	if (frameDt > simMaxFrameTime) {
+		//avoid spiraling after a long stall (window drag, breakpoint)
+		frameDt = simMaxFrameTime;
+	}
+	accumulator += frameDt;
+
+	unsigned int ticks = 0;
+	while (accumulator >= tickDt) {
+		if (tickCallback) {
+			tickCallback(tickUser, state, inputs);
+		}
+		previous = state;
+		step(inputs, tickDt);
+		accumulator -= tickDt;
+		ticks++;
+	}
+	return ticks;
+}
+
+//how far between the last tick and the next one we are, for rendering
+double PongSim::alpha() const {
+	return accumulator / tickDt;
+}
+
+PongState interpolateState(const PongState& previous, const PongState& current, double alpha) {
+	PongState state = current;
+	if (previous.scores[0] != current.scores[0] || previous.scores[1] != current.scores[1]) {
+		//the ball was put back in the middle, don't sweep it across the field
+		return state;
+	}
+	simfloat t = simfloat(alpha < 0.0 ? 0.0 : (alpha > 1.0 ? 1.0 : alpha));
+	for (int i = 0; i < 2; i++) {
+		state.paddleY[i] = previous.paddleY[i] + (current.paddleY[i] - previous.paddleY[i]) * t;
+	}
+	state.ballX = previous.ballX + (current.ballX - previous.ballX) * t;
+	state.ballY = previous.ballY + (current.ballY - previous.ballY) * t;
+	return state;
+}
+
+uint64_t hashBytes(uint64_t hash, const void* data, size_t size) {
+	const unsigned char* bytes = (const unsigned char*)data;
+	for (size_t i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+//fnv-1a over the fields one by one so struct padding never leaks into the hash
+uint64_t hashState(const PongState& state) {
+	uint64_t hash = hashSeed;
+	hash = hashBytes(hash, state.paddleY, sizeof(state.paddleY));
+	hash = hashBytes(hash, state.paddleVelocities, sizeof(state.paddleVelocities));
+	hash = hashBytes(hash, &state.ballX, sizeof(state.ballX));
+	hash = hashBytes(hash, &state.ballY, sizeof(state.ballY));
+	hash = hashBytes(hash, &state.ballVX, sizeof(state.ballVX));
+	hash = hashBytes(hash, &state.ballVY, sizeof(state.ballVY));
+	hash = hashBytes(hash, state.scores, sizeof(state.scores));
+	hash = hashBytes(hash, &state.tick, sizeof(state.tick));
+	return hash;
+}
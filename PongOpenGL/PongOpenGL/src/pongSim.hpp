@@ -0,0 +1,126 @@
+#ifndef PONGSIM_H
+#define PONGSIM_H
+
+#include <cstddef>
+#include <cstdint>
+#include "fixed.hpp"
+#include "sweep.hpp"
+
+/*
+	headless pong simulation, no GL or GLFW so it can be linked and stepped on its own
+
+	define PONG_FIXED_POINT to run the simulation on Fixed instead of float, every
+	build then produces the same state tick for tick (check with hashState)
+*/
+
+#ifdef PONG_FIXED_POINT
+typedef Fixed simfloat;
+#else
+typedef float simfloat;
+#endif
+
+//game parameters
+const float paddleSpeed = 250.0f;
+const float paddleHeight = 100.0f;
+const float halfPaddleHeight = paddleHeight / 2.0f;
+const float paddleWidth = 10.0f;
+const float halfPaddleWidth = paddleWidth / 2.0f;
+const float paddleInset = 35.0f;
+const float ballDiameter = 10.0f;
+const float ballRadius = ballDiameter / 2.0f;
+const float paddleBoundary = (paddleHeight / 2.0f) + (ballDiameter / 2.0f);
+const float paddleSpin = 0.5f;
+const float ballSpeedup = 0.01f;
+
+const double simTickRate = 120.0;
+const double simMaxFrameTime = 0.25;
+const unsigned int maxBouncesPerStep = 8;
+
+struct vec2 {
+	float x;
+	float y;
+};
+
+const vec2 initBallVelocity = { 150.0f, 150.0f };
+
+//input bits, one per key
+enum InputBits : unsigned char {
+	INPUT_LEFT_UP = 1 << 0,
+	INPUT_LEFT_DOWN = 1 << 1,
+	INPUT_RIGHT_UP = 1 << 2,
+	INPUT_RIGHT_DOWN = 1 << 3
+};
+
+struct Inputs {
+	unsigned char buttons;
+};
+
+//buttons held for part of a tick, a tick's segments add up to its length
+struct InputSegment {
+	unsigned char buttons;
+	double duration;
+};
+
+typedef SweepHit<simfloat> Hit;
+
+//points returned from a step, same codes as the old reset flag
+enum Point : unsigned char {
+	POINT_NONE = 0,
+	POINT_RIGHT = 1,
+	POINT_LEFT = 2
+};
+
+//whole game state, plain data so it can be copied around freely
+struct PongState {
+	simfloat paddleY[2];
+	simfloat paddleVelocities[2];
+	simfloat ballX;
+	simfloat ballY;
+	simfloat ballVX;
+	simfloat ballVY;
+	unsigned int scores[2];
+	unsigned int tick;
+};
+
+//called by advance before every tick, used for recording
+typedef void (*TickCallback)(void* user, const PongState& before, const Inputs& inputs);
+
+class PongSim {
+public:
+	simfloat width;
+	simfloat height;
+	double tickDt;
+	double accumulator;
+	PongState state;
+
+	//state before the last tick advance ran, for interpolating
+	PongState previous;
+
+	TickCallback tickCallback;
+	void* tickUser;
+
+	PongSim(float width, float height, double tickRate = simTickRate);
+
+	void reset();
+	unsigned char step(const Inputs& inputs, double dt);
+	unsigned char step(const InputSegment* segments, unsigned int count, double dt);
+	unsigned int advance(const Inputs& inputs, double frameDt);
+	double alpha() const;
+
+	simfloat paddleX(int i) const;
+	bool sweepBall(simfloat maxT, Hit& hit) const;
+
+private:
+	void movePaddles(unsigned char buttons, simfloat dt);
+	unsigned char moveBall(simfloat dt);
+};
+
+//fnv-1a, chain calls starting from hashSeed
+const uint64_t hashSeed = 14695981039346656037ull;
+uint64_t hashBytes(uint64_t hash, const void* data, size_t size);
+uint64_t hashState(const PongState& state);
+
+//paddles and ball alpha of the way from previous to current, snaps after a point
+PongState interpolateState(const PongState& previous, const PongState& current, double alpha);
+
+#endif
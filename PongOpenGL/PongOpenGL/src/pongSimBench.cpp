@@ -0,0 +1,22 @@
+#include "headless.hpp"
+#include <iostream>
+
+/*
+	pongsim_bench, the headless modes without the game, builds wherever pongsim does
+*/
+
+//same field as the game window
+const float fieldWidth = 800.0f;
+const float fieldHeight = 600.0f;
+
+int main(int argc, char** argv) {
+	int exitCode = 0;
+	if (runHeadless(argc, argv, fieldWidth, fieldHeight, exitCode)) {
+		return exitCode;
+	}
+
+	std::cout << "usage: " << argv[0] << " --bench-sim | --bench-multiball | --bench-threads [--pin]"
+		" | --bench-rollback | --bench-ai | --bench-vecenv | --bench-shm | --shm-serve NAME ENVS"
+		" | --test-batch | --test-ai | --test-shm | --play FILE | --verify FILE" << std::endl;
+	return 1;
+}
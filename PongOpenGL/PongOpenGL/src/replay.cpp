@@ -0,0 +1,283 @@
+#include "replay.hpp"
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*
+	WRITER
+*/
+
+ReplayWriter::ReplayWriter(const char* filename, const PongSim& sim, unsigned int keyframeInterval)
+	: buffer(replayBufferSize), used(0), keyframeInterval(keyframeInterval ? keyframeInterval : 1), ticks(0) {
+	file.open(filename, std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) {
+		std::cout << "Could not open " << filename << std::endl;
+		return;
+	}
+
+	ReplayHeader header;
+	memcpy(header.magic, replayMagic, sizeof(header.magic));
+	header.version = replayVersion;
+	header.keyframeInterval = this->keyframeInterval;
+	header.stateSize = sizeof(PongState);
+	header.tickDt = sim.tickDt;
+	header.width = toFloat(sim.width);
+	header.height = toFloat(sim.height);
+	append(&header, sizeof(header));
+}
+
+ReplayWriter::~ReplayWriter() {
+	close();
+}
+
+bool ReplayWriter::isOpen() const {
+	return file.is_open();
+}
+
+void ReplayWriter::append(const void* data, size_t size) {
+	if (used + size > buffer.size()) {
+		flush();
+	}
+	memcpy(buffer.data() + used, data, size);
+	used += size;
+}
+
+//one call per tick with the state before that tick
+void ReplayWriter::record(const PongState& before, const Inputs& inputs) {
+	if (!file.is_open()) {
+		return;
+	}
+	if (ticks % keyframeInterval == 0) {
+		append(&before, sizeof(before));
+	}
+	append(&inputs.buttons, sizeof(inputs.buttons));
+	ticks++;
+}
+
+void ReplayWriter::flush() {
+	if (used > 0 && file.is_open()) {
+		file.write(buffer.data(), used);
+	}
+	used = 0;
+}
+
+void ReplayWriter::close() {
+	if (file.is_open()) {
+		flush();
+		file.close();
+	}
+}
+
+void ReplayWriter::onTick(void* user, const PongState& before, const Inputs& inputs) {
+	((ReplayWriter*)user)->record(before, inputs);
+}
+
+/*
+	READER
+*/
+
+ReplayReader::ReplayReader(const char* filename)
+	: tickCount(0), data(nullptr), size(0), blockSize(0) {
+	memset(&header, 0, sizeof(header));
+
+#ifdef _WIN32
+	fileHandle = NULL;
+	mappingHandle = NULL;
+	HANDLE fileH = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (fileH == INVALID_HANDLE_VALUE) {
+		std::cout << "Could not open " << filename << std::endl;
+		return;
+	}
+	LARGE_INTEGER fileSize;
+	GetFileSizeEx(fileH, &fileSize);
+	HANDLE mappingH = fileSize.QuadPart > 0 ? CreateFileMappingA(fileH, NULL, PAGE_READONLY, 0, 0, NULL) : NULL;
+	if (!mappingH) {
+		CloseHandle(fileH);
+		std::cout << "Could not map " << filename << std::endl;
+		return;
+	}
+	fileHandle = fileH;
+	mappingHandle = mappingH;
+	data = (const unsigned char*)MapViewOfFile(mappingH, FILE_MAP_READ, 0, 0, 0);
+	size = (size_t)fileSize.QuadPart;
+#else
+	int fd = open(filename, O_RDONLY);
+	if (fd < 0) {
+		std::cout << "Could not open " << filename << std::endl;
+		return;
+	}
+	struct stat info;
+	if (fstat(fd, &info) == 0 && info.st_size > 0) {
+		void* mapped = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapped != MAP_FAILED) {
+			data = (const unsigned char*)mapped;
+			size = (size_t)info.st_size;
+		}
+	}
+	::close(fd);
+#endif
+
+	if (!data) {
+		std::cout << "Could not map " << filename << std::endl;
+		unmap();
+		return;
+	}
+
+	//validate before trusting any offsets
+	if (size < sizeof(header)) {
+		std::cout << filename << " is not a replay" << std::endl;
+		unmap();
+		return;
+	}
+	memcpy(&header, data, sizeof(header));
+	if (memcmp(header.magic, replayMagic, sizeof(header.magic)) != 0 ||
+		header.version != replayVersion ||
+		header.stateSize != sizeof(PongState) ||
+		header.keyframeInterval == 0) {
+		std::cout << filename << " is not a compatible replay" << std::endl;
+		unmap();
+		return;
+	}
+
+	blockSize = sizeof(PongState) + header.keyframeInterval;
+	size_t body = size - sizeof(header);
+	size_t tail = body % blockSize;
+	tickCount = (unsigned int)((body / blockSize) * header.keyframeInterval);
+	if (tail > sizeof(PongState)) {
+		tickCount += (unsigned int)(tail - sizeof(PongState));
+	}
+}
+
+ReplayReader::~ReplayReader() {
+	unmap();
+}
+
+void ReplayReader::unmap() {
+#ifdef _WIN32
+	if (data) {
+		UnmapViewOfFile(data);
+	}
+	if (mappingHandle) {
+		CloseHandle((HANDLE)mappingHandle);
+	}
+	if (fileHandle) {
+		CloseHandle((HANDLE)fileHandle);
+	}
+	mappingHandle = NULL;
+	fileHandle = NULL;
+#else
+	if (data) {
+		munmap((void*)data, size);
+	}
+#endif
+	data = nullptr;
+	size = 0;
+	tickCount = 0;
+}
+
+bool ReplayReader::isOpen() const {
+	return data != nullptr;
+}
+
+//copied out, blocks are not guaranteed to be aligned for PongState
+void ReplayReader::keyframe(unsigned int block, PongState& state) const {
+	memcpy(&state, data + sizeof(header) + block * blockSize, sizeof(PongState));
+}
+
+Inputs ReplayReader::input(unsigned int tick) const {
+	unsigned int block = tick / header.keyframeInterval;
+	unsigned int index = tick % header.keyframeInterval;
+	Inputs inputs;
+	inputs.buttons = data[sizeof(header) + block * blockSize + sizeof(PongState) + index];
+	return inputs;
+}
+
+/*
+	PLAYER
+*/
+
+ReplayPlayer::ReplayPlayer(const ReplayReader& reader)
+	: reader(reader), sim(reader.header.width, reader.header.height), position(0) {
+	sim.tickDt = reader.header.tickDt;
+	if (reader.isOpen() && reader.tickCount > 0) {
+		reader.keyframe(0, sim.state);
+	}
+}
+
+unsigned int ReplayPlayer::tick() const {
+	return position;
+}
+
+bool ReplayPlayer::done() const {
+	return position >= reader.tickCount;
+}
+
+//restore the keyframe at or before tick (unless we are already in that block) and step forward
+void ReplayPlayer::seek(unsigned int tick) {
+	if (!reader.isOpen() || reader.tickCount == 0) {
+		return;
+	}
+	tick = tick > reader.tickCount ? reader.tickCount : tick;
+
+	unsigned int interval = reader.header.keyframeInterval;
+	unsigned int block = tick / interval;
+	if (block * interval == reader.tickCount && block > 0) {
+		//the file stops right at a block boundary, that block has no keyframe
+		block--;
+	}
+
+	if (tick < position || block != position / interval) {
+		reader.keyframe(block, sim.state);
+		position = block * interval;
+	}
+	playTo(tick);
+}
+
+unsigned char ReplayPlayer::stepOne() {
+	if (done()) {
+		return POINT_NONE;
+	}
+	unsigned char point = sim.step(reader.input(position), reader.header.tickDt);
+	position++;
+	return point;
+}
+
+//as fast as possible, returns how many ticks were run
+unsigned int ReplayPlayer::playTo(unsigned int tick) {
+	unsigned int start = position;
+	while (position < tick && !done()) {
+		stepOne();
+	}
+	return position - start;
+}
+
+//replay from the start and compare against every recorded keyframe, the keyframes
+//came from the build that recorded so this checks two builds agree tick for tick.
+//traceHash folds in the state hash of every tick for comparing runs without a file
+bool ReplayPlayer::verify(unsigned int& mismatchTick, uint64_t& traceHash) {
+	seek(0);
+	traceHash = hashState(sim.state);
+	unsigned int interval = reader.header.keyframeInterval;
+	PongState recorded;
+	while (!done()) {
+		stepOne();
+		traceHash = (traceHash ^ hashState(sim.state)) * 1099511628211ull;
+		if (position % interval == 0 && position < reader.tickCount) {
+			reader.keyframe(position / interval, recorded);
+			if (hashState(recorded) != hashState(sim.state)) {
+				mismatchTick = position;
+				return false;
+			}
+		}
+	}
+	return true;
+}
@@ -0,0 +1,107 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <vector>
+#include "pongSim.hpp"
+
+/*
+	replay files
+
+	header, then blocks of [keyframe PongState][keyframeInterval input bytes].
+	the keyframe is the state before the first tick of its block, so seeking to
+	any tick is one copy plus at most keyframeInterval - 1 steps. the last block
+	can be short, the tick count comes from the file size. PongState is written
+	as is, so float and PONG_FIXED_POINT builds can't read each other's files.
+*/
+
+const char replayMagic[4] = { 'P', 'R', 'P', 'L' };
+const uint32_t replayVersion = 1;
+const unsigned int replayKeyframeInterval = 600;
+const size_t replayBufferSize = 1 << 16;
+
+struct ReplayHeader {
+	char magic[4];
+	uint32_t version;
+	uint32_t keyframeInterval;
+	uint32_t stateSize;
+	double tickDt;
+	float width;
+	float height;
+};
+
+//buffered, append only
+class ReplayWriter {
+public:
+	ReplayWriter(const char* filename, const PongSim& sim, unsigned int keyframeInterval = replayKeyframeInterval);
+	~ReplayWriter();
+	ReplayWriter(const ReplayWriter&) = delete;
+	ReplayWriter& operator=(const ReplayWriter&) = delete;
+
+	bool isOpen() const;
+	void record(const PongState& before, const Inputs& inputs);
+	void flush();
+	void close();
+
+	//hook for PongSim::tickCallback, user is the writer
+	static void onTick(void* user, const PongState& before, const Inputs& inputs);
+
+private:
+	std::ofstream file;
+	std::vector<char> buffer;
+	size_t used;
+	unsigned int keyframeInterval;
+	unsigned int ticks;
+
+	void append(const void* data, size_t size);
+};
+
+//whole file memory mapped, read only
+class ReplayReader {
+public:
+	ReplayHeader header;
+	unsigned int tickCount;
+
+	ReplayReader(const char* filename);
+	~ReplayReader();
+	ReplayReader(const ReplayReader&) = delete;
+	ReplayReader& operator=(const ReplayReader&) = delete;
+
+	bool isOpen() const;
+	void keyframe(unsigned int block, PongState& state) const;
+	Inputs input(unsigned int tick) const;
+
+private:
+	const unsigned char* data;
+	size_t size;
+	size_t blockSize;
+#ifdef _WIN32
+	void* fileHandle;
+	void* mappingHandle;
+#endif
+
+	void unmap();
+};
+
+//headless playback with seeking
+class ReplayPlayer {
+public:
+	const ReplayReader& reader;
+	PongSim sim;
+
+	ReplayPlayer(const ReplayReader& reader);
+
+	unsigned int tick() const;
+	bool done() const;
+	void seek(unsigned int tick);
+	unsigned char stepOne();
+	unsigned int playTo(unsigned int tick);
+	bool verify(unsigned int& mismatchTick, uint64_t& traceHash);
+
+private:
+	unsigned int position;
+};
+
+#endif
@@ -0,0 +1,127 @@
+#include "rollback.hpp"
+#include <cstring>
+
+RollbackSession::RollbackSession(PongSim& sim, int localPlayer)
+	: sim(sim), localPlayer(localPlayer), confirmedTick(sim.state.tick), reportedTick(sim.state.tick),
+	rollbacks(0), resimulatedTicks(0), maxRollback(0),
+	lastRemoteButtons(0), mispredictedTick(noTick) {
+	localMask = localPlayer == 0 ? (INPUT_LEFT_UP | INPUT_LEFT_DOWN) : (INPUT_RIGHT_UP | INPUT_RIGHT_DOWN);
+	remoteMask = localPlayer == 0 ? (INPUT_RIGHT_UP | INPUT_RIGHT_DOWN) : (INPUT_LEFT_UP | INPUT_LEFT_DOWN);
+
+	memset(snapshots, 0, sizeof(snapshots));
+	memset(localInputs, 0, sizeof(localInputs));
+	memset(remoteInputs, 0, sizeof(remoteInputs));
+	memset(remoteUsed, 0, sizeof(remoteUsed));
+	for (unsigned int i = 0; i < rollbackWindow; i++) {
+		remoteTicks[i] = noTick;
+	}
+}
+
+unsigned int RollbackSession::currentTick() const {
+	return sim.state.tick;
+}
+
+//stop running ahead once the oldest unconfirmed snapshot would be overwritten
+bool RollbackSession::canAdvance() const {
+	return confirmedTick >= currentTick() || currentTick() - confirmedTick < rollbackWindow - 1;
+}
+
+unsigned char RollbackSession::localInput(unsigned int tick) const {
+	return localInputs[tick % rollbackWindow];
+}
+
+//state before tick ran, only valid for the last rollbackWindow ticks
+const PongState& RollbackSession::stateAt(unsigned int tick) const {
+	return snapshots[tick % rollbackWindow];
+}
+
+//snapshot, pick the remote input (real or predicted), step
+unsigned char RollbackSession::simulate(unsigned int tick) {
+	unsigned int index = tick % rollbackWindow;
+	memcpy(&snapshots[index], &sim.state, sizeof(PongState));
+
+	unsigned char remote = remoteTicks[index] == tick ? remoteInputs[index] : lastRemoteButtons;
+	remoteUsed[index] = remote;
+
+	Inputs inputs;
+	inputs.buttons = localInputs[index] | remote;
+	return sim.step(inputs, sim.tickDt);
+}
+
+//one new tick with the local player's buttons
+unsigned char RollbackSession::advance(unsigned char localButtons) {
+	applyCorrections();
+
+	unsigned int tick = currentTick();
+	localInputs[tick % rollbackWindow] = localButtons & localMask;
+	return simulate(tick);
+}
+
+//returns false if the input is too far ahead to hold yet
+bool RollbackSession::addRemoteInput(unsigned int tick, unsigned char remoteButtons) {
+	if (tick < confirmedTick) {
+		//already have it, resent for redundancy
+		return true;
+	}
+
+	//the slot must not still be needed by a pending rollback, a tick we have not simulated or one not reported yet
+	unsigned int oldestNeeded = mispredictedTick < confirmedTick ? mispredictedTick : confirmedTick;
+	oldestNeeded = currentTick() < oldestNeeded ? currentTick() : oldestNeeded;
+	oldestNeeded = reportedTick < oldestNeeded ? reportedTick : oldestNeeded;
+	if (tick >= oldestNeeded + rollbackWindow) {
+		return false;
+	}
+
+	unsigned int index = tick % rollbackWindow;
+	remoteInputs[index] = remoteButtons & remoteMask;
+	remoteTicks[index] = tick;
+
+	//already simulated with a guess that turned out wrong
+	if (tick < currentTick() && remoteUsed[index] != remoteInputs[index] && tick < mispredictedTick) {
+		mispredictedTick = tick;
+	}
+
+	//inputs arrive out of order, confirm as far as there are no gaps
+	while (remoteTicks[confirmedTick % rollbackWindow] == confirmedTick) {
+		lastRemoteButtons = remoteInputs[confirmedTick % rollbackWindow];
+		confirmedTick++;
+	}
+	return true;
+}
+
+//snapshots are only final once no rollback is pending, so this runs after corrections
+void RollbackSession::reportConfirmed() {
+	unsigned int target = confirmedTick < currentTick() ? confirmedTick : currentTick();
+	for (; reportedTick < target; reportedTick++) {
+		if (sim.tickCallback) {
+			unsigned int index = reportedTick % rollbackWindow;
+			Inputs inputs;
+			inputs.buttons = localInputs[index] | remoteInputs[index];
+			sim.tickCallback(sim.tickUser, snapshots[index], inputs);
+		}
+	}
+}
+
+//restore the earliest mispredicted tick and simulate back up to now, returns ticks resimulated
+unsigned int RollbackSession::applyCorrections() {
+	if (mispredictedTick == noTick) {
+		reportConfirmed();
+		return 0;
+	}
+
+	unsigned int target = currentTick();
+	unsigned int tick = mispredictedTick;
+	mispredictedTick = noTick;
+
+	memcpy(&sim.state, &snapshots[tick % rollbackWindow], sizeof(PongState));
+	for (unsigned int t = tick; t < target; t++) {
+		simulate(t);
+	}
+
+	unsigned int count = target - tick;
+	rollbacks++;
+	resimulatedTicks += count;
+	maxRollback = count > maxRollback ? count : maxRollback;
+	reportConfirmed();
+	return count;
+}
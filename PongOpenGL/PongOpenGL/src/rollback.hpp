@@ -0,0 +1,65 @@
+#ifndef ROLLBACK_H
+#define ROLLBACK_H
+
+#include "pongSim.hpp"
+
+/*
+	rollback for two player online play
+
+	every tick the state before it is copied into a ring (one memcpy of PongState)
+	and the remote player's input is predicted as "same as last time". when the
+	real remote input arrives and differs, the state at that tick is restored and
+	every tick since is simulated again with the corrected inputs.
+
+	sim.tickCallback (replay recording) only sees ticks once both players'
+	inputs for them are in and no rollback is pending, so it gets each tick
+	exactly once with the inputs that really happened.
+*/
+
+const unsigned int rollbackWindow = 16;
+const unsigned int noTick = 0xFFFFFFFF;
+
+class RollbackSession {
+public:
+	PongSim& sim;
+	int localPlayer;
+
+	//first tick whose remote input has not arrived yet
+	unsigned int confirmedTick;
+	//first tick not yet passed to sim.tickCallback
+	unsigned int reportedTick;
+
+	//stats
+	unsigned int rollbacks;
+	unsigned int resimulatedTicks;
+	unsigned int maxRollback;
+
+	RollbackSession(PongSim& sim, int localPlayer);
+
+	unsigned int currentTick() const;
+	bool canAdvance() const;
+	unsigned char localInput(unsigned int tick) const;
+	const PongState& stateAt(unsigned int tick) const;
+
+	unsigned char advance(unsigned char localButtons);
+	bool addRemoteInput(unsigned int tick, unsigned char remoteButtons);
+	unsigned int applyCorrections();
+
+private:
+	PongState snapshots[rollbackWindow];
+	unsigned char localInputs[rollbackWindow];
+	unsigned char remoteInputs[rollbackWindow];
+	unsigned char remoteUsed[rollbackWindow];
+	unsigned int remoteTicks[rollbackWindow];
+	unsigned char lastRemoteButtons;
+	unsigned char localMask;
+	unsigned char remoteMask;
+
+	//earliest tick simulated with a wrong prediction, noTick if none
+	unsigned int mispredictedTick;
+
+	unsigned char simulate(unsigned int tick);
+	void reportConfirmed();
+};
+
+#endif
@@ -0,0 +1,168 @@
+#include "sceneBatch.hpp"
+#include <cmath>
+#include <cstddef>
+
+const GLuint meshLayout = 0;
+const GLuint offsetLayout = 1;
+const GLuint sizeLayout = 2;
+const GLuint colorLayout = 3;
+const GLuint cornerLayout = 4;
+
+SceneBatch::SceneBatch(StreamMode mode, GLuint initialInstances)
+	: vao(), meshVBO(), meshEBO(),
+	instanceStream(initialInstances * sizeof(SceneInstance), mode),
+	commandStream(16 * sizeof(DrawElementsIndirectCommand), mode),
+	path(glExt.multiDrawIndirect ? SCENE_MULTI_DRAW_INDIRECT : (glExt.baseInstance ? SCENE_BASE_INSTANCE : SCENE_BASE_VERTEX)),
+	mapped(NULL), instanceCapacity(0), instanceCount(0) {}
+
+unsigned int SceneBatch::addMesh(const GLfloat* vertices, GLuint vertexCount, const GLuint* indices, GLuint indexCount) {
+	SceneMesh mesh;
+	mesh.firstIndex = (GLuint)indexData.size();
+	mesh.indexCount = indexCount;
+	mesh.baseVertex = (GLint)(vertexData.size() / 2);
+	vertexData.insert(vertexData.end(), vertices, vertices + vertexCount * 2);
+	indexData.insert(indexData.end(), indices, indices + indexCount);
+	meshes.push_back(mesh);
+	return (unsigned int)meshes.size() - 1;
+}
+
+void SceneBatch::uploadMeshes() {
+	vao.Bind();
+
+	GLuint names[2];
+	glGenBuffers(2, names);
+	meshVBO.reset(names[0]);
+	meshEBO.reset(names[1]);
+
+	glStateBindBuffer(GL_ARRAY_BUFFER, meshVBO);
+	glBufferData(GL_ARRAY_BUFFER, vertexData.size() * sizeof(GLfloat), vertexData.data(), GL_STATIC_DRAW);
+	glVertexAttribPointer(meshLayout, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), 0);
+	glEnableVertexAttribArray(meshLayout);
+
+	//element buffer binding is vao state
+	glStateBindBuffer(GL_ELEMENT_ARRAY_BUFFER, meshEBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexData.size() * sizeof(GLuint), indexData.data(), GL_STATIC_DRAW);
+
+	linkInstances(0);
+	glEnableVertexAttribArray(offsetLayout);
+	glEnableVertexAttribArray(sizeLayout);
+	glEnableVertexAttribArray(colorLayout);
+	glEnableVertexAttribArray(cornerLayout);
+	glVertexAttribDivisor(offsetLayout, 1);
+	glVertexAttribDivisor(sizeLayout, 1);
+	glVertexAttribDivisor(colorLayout, 1);
+	glVertexAttribDivisor(cornerLayout, 1);
+
+	vao.Unbind();
+	glStateBindBuffer(GL_ARRAY_BUFFER, 0);
+	glStateBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+	vertexData.clear();
+	indexData.clear();
+}
+
+//with the vao bound, instance 0 of the attributes starts at offset in the stream
+void SceneBatch::linkInstances(GLintptr offset) {
+	const GLsizei stride = sizeof(SceneInstance);
+	instanceStream.LinkAttri(offsetLayout, 2, GL_FLOAT, GL_FALSE, stride, offset + offsetof(SceneInstance, offset));
+	instanceStream.LinkAttri(sizeLayout, 2, GL_FLOAT, GL_FALSE, stride, offset + offsetof(SceneInstance, size));
+	instanceStream.LinkAttri(colorLayout, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, offset + offsetof(SceneInstance, color));
+	instanceStream.LinkAttri(cornerLayout, 1, GL_FLOAT, GL_FALSE, stride, offset + offsetof(SceneInstance, corner));
+}
+
+void SceneBatch::begin(GLuint maxInstances) {
+	commands.clear();
+	instanceCount = 0;
+	instanceCapacity = maxInstances;
+	mapped = maxInstances ? (SceneInstance*)instanceStream.map(maxInstances * sizeof(SceneInstance)) : NULL;
+}
+
+SceneInstance* SceneBatch::add(unsigned int mesh, GLuint count) {
+	if (!mapped || count == 0 || instanceCount + count > instanceCapacity) {
+		return NULL;
+	}
+	DrawElementsIndirectCommand command;
+	command.count = meshes[mesh].indexCount;
+	command.instanceCount = count;
+	command.firstIndex = meshes[mesh].firstIndex;
+	command.baseVertex = meshes[mesh].baseVertex;
+	command.baseInstance = instanceCount;
+	commands.push_back(command);
+
+	SceneInstance* instances = mapped + instanceCount;
+	instanceCount += count;
+	return instances;
+}
+
+void SceneBatch::draw() {
+	if (!mapped) {
+		return;
+	}
+	GLintptr instanceStart = instanceStream.commit(instanceCount * sizeof(SceneInstance));
+	mapped = NULL;
+
+	vao.Bind();
+	if (path == SCENE_MULTI_DRAW_INDIRECT) {
+		GLintptr commandStart = commandStream.upload(commands.data(), commands.size() * sizeof(DrawElementsIndirectCommand));
+		linkInstances(instanceStart);
+		glStateBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandStream.bufferObj);
+		glExtMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void*)commandStart, (GLsizei)commands.size(), 0);
+		glStateBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+		commandStream.fence();
+	}
+	else if (path == SCENE_BASE_INSTANCE) {
+		linkInstances(instanceStart);
+		for (const DrawElementsIndirectCommand& command : commands) {
+			glExtDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, command.count, GL_UNSIGNED_INT,
+				(void*)(command.firstIndex * sizeof(GLuint)), command.instanceCount, command.baseVertex, command.baseInstance);
+		}
+	}
+	else {
+		for (const DrawElementsIndirectCommand& command : commands) {
+			linkInstances(instanceStart + command.baseInstance * sizeof(SceneInstance));
+			glDrawElementsInstancedBaseVertex(GL_TRIANGLES, command.count, GL_UNSIGNED_INT,
+				(void*)(command.firstIndex * sizeof(GLuint)), command.instanceCount, command.baseVertex);
+		}
+	}
+	instanceStream.fence();
+	vao.Unbind();
+}
+
+void SceneBatch::cancel() {
+	if (mapped) {
+		//nothing was fenced, the region is simply written again next frame
+		instanceStream.commit(0);
+		mapped = NULL;
+	}
+	commands.clear();
+	instanceCount = 0;
+}
+
+void SceneBatch::Delete() {
+	vao.Delete();
+	meshVBO.reset();
+	meshEBO.reset();
+	instanceStream.Delete();
+	commandStream.Delete();
+}
+
+//fan of numTriangles around the centre, the last triangle wraps back to vertex 1
+void gen2DCircleArray(std::vector<GLfloat>& vertices, std::vector<GLuint>& indices, unsigned int numTriangles, GLfloat radius) {
+	vertices.assign((numTriangles + 1) * 2, 0.0f);
+	indices.assign(numTriangles * 3, 0);
+
+	GLfloat theta = 0.0f;
+
+	for (GLuint i = 0; i < numTriangles; i++) {
+		vertices[(i + 1) * 2] = radius * cosf(theta);
+		vertices[(i + 1) * 2 + 1] = radius * sinf(theta);
+
+		indices[i * 3 + 0] = 0;
+		indices[i * 3 + 1] = i + 1;
+		indices[i * 3 + 2] = i + 2;
+
+		theta += (GLfloat)((2 * 3.14159265358979323846) / numTriangles);
+	}
+
+	indices[(numTriangles - 1) * 3 + 2] = 1;
+}
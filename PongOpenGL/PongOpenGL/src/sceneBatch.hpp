@@ -0,0 +1,84 @@
+#ifndef SCENEBATCH_H
+#define SCENEBATCH_H
+
+#include <glad/glad.h>
+#include <vector>
+#include "VAO.hpp"
+#include "glExt.hpp"
+#include "streamBuffer.hpp"
+
+//one drawn copy of a mesh, matches vertex attributes 1 (offset), 2 (size), 3 (color)
+//and 4 (corner, the radius the shader rounds the box's corners by, 0 for sharp)
+struct SceneInstance {
+	GLfloat offset[2];
+	GLfloat size[2];
+	GLubyte color[4];
+	GLfloat corner;
+};
+
+//where a mesh sits in the merged vertex/index buffers
+struct SceneMesh {
+	GLuint firstIndex;
+	GLuint indexCount;
+	GLint baseVertex;
+};
+
+enum SceneDrawPath {
+	SCENE_MULTI_DRAW_INDIRECT,	//every mesh in one glMultiDrawElementsIndirect
+	SCENE_BASE_INSTANCE,		//a draw per mesh, base instance picks its instances
+	SCENE_BASE_VERTEX			//plain 3.3, a draw per mesh with the instance attributes re-pointed
+};
+
+/*
+	every mesh in one vertex and one index buffer, every instance in one stream
+
+	meshes are added once at startup and uploaded together. each frame begin maps
+	room for the frame's instances, add hands out a run of them for one mesh and
+	records a draw command, and draw submits them all. with multi draw indirect
+	that is a single call however many kinds of object there are, the fallbacks
+	issue one call per mesh but still share the vao and buffers.
+*/
+class SceneBatch {
+public:
+	VAO vao;
+	BufferHandle meshVBO;
+	BufferHandle meshEBO;
+	StreamBuffer instanceStream;
+	StreamBuffer commandStream;
+	SceneDrawPath path;
+
+	std::vector<SceneMesh> meshes;
+	std::vector<DrawElementsIndirectCommand> commands;
+
+	SceneBatch(StreamMode mode, GLuint initialInstances = 64);
+
+	//vertices are x, y pairs, returns the mesh id for add
+	unsigned int addMesh(const GLfloat* vertices, GLuint vertexCount, const GLuint* indices, GLuint indexCount);
+	//after the last addMesh
+	void uploadMeshes();
+
+	//room for up to maxInstances this frame
+	void begin(GLuint maxInstances);
+	//count instances of mesh to fill in, NULL past begin's maxInstances or if the stream didn't map
+	SceneInstance* add(unsigned int mesh, GLuint count);
+	//the shader program must already be active
+	void draw();
+	//drops this frame's instances without drawing, e.g. when add ran out of room
+	void cancel();
+
+	void Delete();
+
+private:
+	std::vector<GLfloat> vertexData;
+	std::vector<GLuint> indexData;
+	SceneInstance* mapped;
+	GLuint instanceCapacity;
+	GLuint instanceCount;
+
+	void linkInstances(GLintptr offset);
+};
+
+//triangle fan around the origin, numTriangles + 1 vertices as x, y pairs
+void gen2DCircleArray(std::vector<GLfloat>& vertices, std::vector<GLuint>& indices, unsigned int numTriangles, GLfloat radius = 0.5f);
+
+#endif
@@ -1,4 +1,6 @@
 #include "shader.hpp"
+#include "shaderLoader.hpp"
+#include "viewUniforms.hpp"
 
 //Read File
 std::string readFile(const char* filename) {
@@ -48,7 +50,6 @@ GLuint genShader(const char* filepath, GLenum type) {
 
 GLuint genShaderString(std::string filestring, GLenum type) {
 	const GLchar* shader = filestring.c_str();
-	std::cout << "Shader:" << std::endl << shader << std::endl;
 
 	//build and compile the shader
 	GLuint shaderInt = glCreateShader(type);
@@ -71,73 +72,53 @@ GLuint genShaderString(std::string filestring, GLenum type) {
 }
 
 
-/*
-	SHADER CLASS
-*/
-Shader::Shader(const char* vertexShaderFile, const char* fragmentShaderFile) {
-	shaderObj = glCreateProgram();
-
-	//compile shaders
-	GLuint vertexShader = genShader(vertexShaderFile, GL_VERTEX_SHADER);
-	GLuint fragmentShader = genShader(fragmentShaderFile, GL_FRAGMENT_SHADER);
-
-	if (vertexShader == -1 || fragmentShader == -1) {
-		throw(errno);
+//shared per view uniforms live at one binding point, programs without the block skip it
+void bindViewBlock(GLuint program) {
+	GLuint blockIndex = glGetUniformBlockIndex(program, viewBlockName);
+	if (blockIndex != GL_INVALID_INDEX) {
+		glUniformBlockBinding(program, blockIndex, viewBlockBinding);
 	}
-
-	//link shader
-	glAttachShader(shaderObj, vertexShader);
-	glAttachShader(shaderObj, fragmentShader);
-	glLinkProgram(shaderObj);
-
-	//check for errors
-	int success;
-	char infoLog[512];
-	glGetShaderiv(shaderObj, GL_LINK_STATUS, &success);
-	if (!success) {
-		glGetShaderInfoLog(shaderObj, 512, NULL, infoLog);
-		std::cout << "Error in shader linking:" << std::endl << infoLog << std::endl;
-		throw(errno);
-	}
-
-	glDeleteShader(vertexShader);
-	glDeleteShader(fragmentShader);
 }
 
-Shader::Shader(std::string vertexShaderFile, std::string fragmentShaderFile) {
-	shaderObj = glCreateProgram();
-
-	//compile shaders
-	GLuint vertexShader = genShaderString(vertexShaderFile, GL_VERTEX_SHADER);
-	GLuint fragmentShader = genShaderString(fragmentShaderFile, GL_FRAGMENT_SHADER);
-
-	if (vertexShader == -1 || fragmentShader == -1) {
-		throw(errno);
+//defines are whole "#define NAME VALUE" lines, they have to come after #version
+std::string insertDefines(const std::string& source, const std::string& defines) {
+	if (defines.empty()) {
+		return source;
 	}
-
-	//link shader
-	glAttachShader(shaderObj, vertexShader);
-	glAttachShader(shaderObj, fragmentShader);
-	glLinkProgram(shaderObj);
-
-	//check for errors
-	int success;
-	char infoLog[512];
-	glGetShaderiv(shaderObj, GL_LINK_STATUS, &success);
-	if (!success) {
-		glGetShaderInfoLog(shaderObj, 512, NULL, infoLog);
-		std::cout << "Error in shader linking:" << std::endl << infoLog << std::endl;
-		throw(errno);
+	//the embedded sources start with blank lines, so look for the line rather than the start
+	size_t at = source.find("#version");
+	if (at == std::string::npos) {
+		at = 0;
 	}
+	else {
+		at = source.find('\n', at);
+		at = at == std::string::npos ? source.size() : at + 1;
+	}
+	std::string ret = source.substr(0, at) + defines;
+	if (defines.back() != '\n') {
+		ret += '\n';
+	}
+	return ret + source.substr(at);
+}
+
+/*
+	SHADER CLASS
+*/
+Shader::Shader(const char* vertexShaderFile, const char* fragmentShaderFile)
+	: Shader(readFile(vertexShaderFile), readFile(fragmentShaderFile)) {}
 
-	glDeleteShader(vertexShader);
-	glDeleteShader(fragmentShader);
+//compiles (or loads from the program cache) and waits for it, see ShaderLoader to overlap that
+Shader::Shader(std::string vertexShaderFile, std::string fragmentShaderFile, const std::string& defines) : fromCache(false) {
+	ShaderLoader loader;
+	*this = loader.take(loader.submit(vertexShaderFile, fragmentShaderFile, defines));
 }
 
-void Shader::Activate() {
-	glUseProgram(shaderObj);
+Shader::Shader(ProgramHandle&& program, bool fromCache) : shaderObj(std::move(program)), fromCache(fromCache) {}
+
+void Shader::Activate() const {
+	glStateUseProgram(shaderObj);
 }
 
 void Shader::Delete() {
-	glDeleteProgram(shaderObj);
+	shaderObj.reset();
 }
\ No newline at end of file
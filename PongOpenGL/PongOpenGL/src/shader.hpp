@@ -3,6 +3,8 @@
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
+#include "glHandle.hpp"
+#include "glState.hpp"
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -14,20 +16,22 @@
 std::string readFile(const char* filename);
 GLuint genShader(const char* filepath, GLenum type);
 GLuint genShaderString(std::string filestring, GLenum type);
+void bindViewBlock(GLuint program);
+std::string insertDefines(const std::string& source, const std::string& defines);
 
 class Shader {
 public:
-	GLuint shaderObj;
+	ProgramHandle shaderObj;
+	//linked from the on disk program cache instead of compiled
+	bool fromCache;
+
 	Shader(const char* vertexShaderFile, const char* fragmentShaderFile);
-	Shader(std::string vertexShaderFile, std::string fragmentShaderFile);
+	Shader(std::string vertexShaderFile, std::string fragmentShaderFile, const std::string& defines = "");
+	//an already linked program, from ShaderLoader
+	Shader(ProgramHandle&& program, bool fromCache);
 
-	void Activate();
+	void Activate() const;
 	void Delete();
 };
 
-void setOrthographicProjection(Shader shader,
-	float left, float right,
-	float bottom, float top,
-	float near, float far);
-
 #endif
\ No newline at end of file
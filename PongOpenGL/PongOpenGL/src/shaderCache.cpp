@@ -0,0 +1,145 @@
+#include "shaderCache.hpp"
+#include "glExt.hpp"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+const char* shaderCacheDir = "shadercache";
+
+//fnv-1a, the length goes in first so "ab" + "c" and "a" + "bc" differ
+static uint64_t hashBytes(uint64_t hash, const void* data, size_t size) {
+	uint64_t length = size;
+	const unsigned char* bytes = (const unsigned char*)&length;
+	for (size_t i = 0; i < sizeof(length); i++) {
+		hash ^= bytes[i];
+		hash *= 1099511628211ull;
+	}
+	bytes = (const unsigned char*)data;
+	for (size_t i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+static uint64_t hashString(uint64_t hash, const char* string) {
+	return hashBytes(hash, string ? string : "", string ? strlen(string) : 0);
+}
+
+uint64_t shaderCacheKey(const std::string& vertexSource, const std::string& fragmentSource, const std::string& defines) {
+	uint64_t hash = 14695981039346656037ull;
+	hash = hashString(hash, (const char*)glGetString(GL_RENDERER));
+	hash = hashString(hash, (const char*)glGetString(GL_VERSION));
+	hash = hashBytes(hash, defines.data(), defines.size());
+	hash = hashBytes(hash, vertexSource.data(), vertexSource.size());
+	hash = hashBytes(hash, fragmentSource.data(), fragmentSource.size());
+	return hash;
+}
+
+static std::filesystem::path cachePath(uint64_t key) {
+	std::ostringstream name;
+	name << std::hex;
+	name.width(16);
+	name.fill('0');
+	name << key;
+	return std::filesystem::path(shaderCacheDir) / (name.str() + ".bin");
+}
+
+static bool cacheEnabled() {
+	return shaderCacheDir && glExt.programBinary;
+}
+
+bool loadProgramBinary(GLuint program, uint64_t key) {
+	if (!cacheEnabled()) {
+		return false;
+	}
+	std::filesystem::path path = cachePath(key);
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open()) {
+		return false;
+	}
+
+	ShaderCacheHeader header;
+	std::vector<char> binary;
+	bool valid = file.read((char*)&header, sizeof(header))
+		&& memcmp(header.magic, shaderCacheMagic, sizeof(header.magic)) == 0
+		&& header.version == shaderCacheVersion
+		&& header.key == key
+		&& header.length > 0;
+	if (valid) {
+		binary.resize(header.length);
+		valid = (bool)file.read(binary.data(), header.length);
+	}
+	file.close();
+
+	GLint success = 0;
+	if (valid) {
+		glExtProgramBinary(program, header.format, binary.data(), (GLsizei)header.length);
+		glGetProgramiv(program, GL_LINK_STATUS, &success);
+	}
+	if (!success) {
+		std::cout << "Shader cache entry " << path.string() << " was refused, recompiling" << std::endl;
+		std::error_code error;
+		std::filesystem::remove(path, error);
+		return false;
+	}
+	return true;
+}
+
+void markProgramRetrievable(GLuint program) {
+	if (cacheEnabled()) {
+		glExtProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
+}
+
+void saveProgramBinary(GLuint program, uint64_t key) {
+	if (!cacheEnabled()) {
+		return;
+	}
+	GLint length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0) {
+		return;
+	}
+
+	ShaderCacheHeader header;
+	memcpy(header.magic, shaderCacheMagic, sizeof(header.magic));
+	header.version = shaderCacheVersion;
+	header.key = key;
+	std::vector<char> binary(length);
+	GLsizei written = 0;
+	GLenum format = 0;
+	glExtGetProgramBinary(program, length, &written, &format, binary.data());
+	if (written <= 0) {
+		return;
+	}
+	header.format = format;
+	header.length = (uint32_t)written;
+
+	std::error_code error;
+	std::filesystem::create_directories(shaderCacheDir, error);
+	std::filesystem::path path = cachePath(key);
+	std::filesystem::path temporary = path;
+	temporary += "." + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + ".tmp";
+
+	std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) {
+		std::cout << "Could not open " << temporary.string() << std::endl;
+		return;
+	}
+	file.write((const char*)&header, sizeof(header));
+	file.write(binary.data(), written);
+	file.close();
+	if (!file) {
+		std::filesystem::remove(temporary, error);
+		return;
+	}
+	std::filesystem::rename(temporary, path, error);
+	if (error) {
+		std::filesystem::remove(temporary, error);
+	}
+}
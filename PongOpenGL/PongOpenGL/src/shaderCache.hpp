@@ -0,0 +1,44 @@
+#ifndef SHADERCACHE_H
+#define SHADERCACHE_H
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <string>
+
+/*
+	on disk cache of linked programs (GL_ARB_get_program_binary)
+
+	one file per program in shaderCacheDir, named after a 64 bit key over
+	GL_RENDERER, GL_VERSION, the defines and both stage sources, so a driver
+	update or an edited shader just misses and writes a new file. a driver can
+	still refuse a binary it wrote itself (format dropped, internal version
+	bump), so the link status is checked after glProgramBinary and a refused
+	file is removed for the next launch to rewrite. files are written to a
+	temporary name and renamed, instances starting together never read half a
+	file.
+*/
+
+const char shaderCacheMagic[4] = { 'P', 'S', 'H', 'C' };
+const uint32_t shaderCacheVersion = 1;
+
+struct ShaderCacheHeader {
+	char magic[4];
+	uint32_t version;
+	uint64_t key;
+	uint32_t format;
+	uint32_t length;
+};
+
+//NULL turns the cache off (--no-shader-cache)
+extern const char* shaderCacheDir;
+
+uint64_t shaderCacheKey(const std::string& vertexSource, const std::string& fragmentSource, const std::string& defines);
+
+//true when program is linked from the cached binary, false leaves it to be compiled
+bool loadProgramBinary(GLuint program, uint64_t key);
+//before linking a program that will be saved
+void markProgramRetrievable(GLuint program);
+//after a successful link
+void saveProgramBinary(GLuint program, uint64_t key);
+
+#endif
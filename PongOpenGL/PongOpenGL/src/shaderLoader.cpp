@@ -0,0 +1,137 @@
+#include "shaderLoader.hpp"
+#include "glExt.hpp"
+#include "shaderCache.hpp"
+#include <cassert>
+#include <cerrno>
+#include <iostream>
+
+//compile without asking how it went, the status is read once the program is done
+static GLuint submitShader(const std::string& source, GLenum type) {
+	const GLchar* shader = source.c_str();
+	GLuint shaderInt = glCreateShader(type);
+	glShaderSource(shaderInt, 1, &shader, NULL);
+	glCompileShader(shaderInt);
+	return shaderInt;
+}
+
+static void printCompileLog(GLuint shader) {
+	int success;
+	char infoLog[512];
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+	if (!success) {
+		glGetShaderInfoLog(shader, 512, NULL, infoLog);
+		std::cout << "Error in shader compilation:" << std::endl << infoLog << std::endl;
+	}
+}
+
+//let the driver use as many compiler threads as it likes
+ShaderLoader::ShaderLoader() {
+	if (glExt.parallelShaderCompile) {
+		glExtMaxShaderCompilerThreads(0xFFFFFFFF);
+	}
+}
+
+unsigned int ShaderLoader::submit(const std::string& vertexSource, const std::string& fragmentSource, const std::string& defines) {
+	Job job;
+	job.program.reset(glCreateProgram());
+	job.done = false;
+	job.taken = false;
+
+	std::string vertex = insertDefines(vertexSource, defines);
+	std::string fragment = insertDefines(fragmentSource, defines);
+	job.key = shaderCacheKey(vertex, fragment, defines);
+	job.fromCache = loadProgramBinary(job.program, job.key);
+
+	if (!job.fromCache) {
+		job.vertexShader.reset(submitShader(vertex, GL_VERTEX_SHADER));
+		job.fragmentShader.reset(submitShader(fragment, GL_FRAGMENT_SHADER));
+		glAttachShader(job.program, job.vertexShader);
+		glAttachShader(job.program, job.fragmentShader);
+		markProgramRetrievable(job.program);
+		glLinkProgram(job.program);
+	}
+
+	jobs.push_back(std::move(job));
+	return (unsigned int)(jobs.size() - 1);
+}
+
+//a cached program is linked as soon as glProgramBinary returns
+bool ShaderLoader::isReady(const Job& job) const {
+	if (job.done || job.fromCache) {
+		return true;
+	}
+	if (!glExt.parallelShaderCompile) {
+		return false;
+	}
+	GLint complete = GL_FALSE;
+	glGetProgramiv(job.program, GL_COMPLETION_STATUS_KHR, &complete);
+	return complete == GL_TRUE;
+}
+
+//the only place that reads a status, so the only place that can block
+void ShaderLoader::complete(Job& job) {
+	if (job.done) {
+		return;
+	}
+	job.done = true;
+
+	if (!job.fromCache) {
+		//check for errors
+		int success;
+		char infoLog[512];
+		glGetProgramiv(job.program, GL_LINK_STATUS, &success);
+		if (!success) {
+			printCompileLog(job.vertexShader);
+			printCompileLog(job.fragmentShader);
+			glGetProgramInfoLog(job.program, 512, NULL, infoLog);
+			std::cout << "Error in shader linking:" << std::endl << infoLog << std::endl;
+			throw(errno);
+		}
+
+		glDetachShader(job.program, job.vertexShader);
+		glDetachShader(job.program, job.fragmentShader);
+		job.vertexShader.reset();
+		job.fragmentShader.reset();
+		saveProgramBinary(job.program, job.key);
+	}
+	bindViewBlock(job.program);
+}
+
+bool ShaderLoader::poll() {
+	for (Job& job : jobs) {
+		if (!job.done && isReady(job)) {
+			complete(job);
+		}
+	}
+	return pending() == 0;
+}
+
+void ShaderLoader::finish() {
+	for (Job& job : jobs) {
+		complete(job);
+	}
+}
+
+bool ShaderLoader::done(unsigned int id) const {
+	return jobs[id].done;
+}
+
+Shader ShaderLoader::take(unsigned int id) {
+	Job& job = jobs[id];
+	if (job.taken) {
+		std::cout << "Shader program " << id << " was already taken" << std::endl;
+		assert(!"ShaderLoader::take called twice for one id");
+		return Shader(ProgramHandle(), job.fromCache);
+	}
+	complete(job);
+	job.taken = true;
+	return Shader(std::move(job.program), job.fromCache);
+}
+
+unsigned int ShaderLoader::pending() const {
+	unsigned int count = 0;
+	for (const Job& job : jobs) {
+		count += job.done ? 0 : 1;
+	}
+	return count;
+}
@@ -0,0 +1,60 @@
+#ifndef SHADERLOADER_H
+#define SHADERLOADER_H
+
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+#include "glHandle.hpp"
+#include "shader.hpp"
+
+/*
+	submit every program up front, collect them when they are needed
+
+	submit only issues glCompileShader/glLinkProgram (or glProgramBinary from
+	the cache) and never asks for a status, so the driver is free to compile in
+	the background while the caller sets up the window, buffers and sim. with
+	GL_KHR_parallel_shader_compile poll asks GL_COMPLETION_STATUS_KHR and only
+	finishes programs that are done, without it nothing can be asked without
+	blocking, so the work is left to take/finish as late as possible. a program
+	that failed prints its logs and throws like Shader does. stages and programs
+	are handles, so a loader dropped with work pending makes no gl calls.
+*/
+class ShaderLoader {
+public:
+	ShaderLoader();
+	ShaderLoader(const ShaderLoader&) = delete;
+	ShaderLoader& operator=(const ShaderLoader&) = delete;
+
+	//returns the id to take the program by
+	unsigned int submit(const std::string& vertexSource, const std::string& fragmentSource, const std::string& defines = "");
+
+	//never blocks, true once every submitted program is done
+	bool poll();
+	//blocks until every submitted program is done
+	void finish();
+	//never blocks, true once poll (or finish) has found that program done
+	bool done(unsigned int id) const;
+	//blocks until that program is done and hands it over, once per id. a second take
+	//asserts, and logs and returns an empty program where asserts are compiled out
+	Shader take(unsigned int id);
+
+	unsigned int pending() const;
+
+private:
+	struct Job {
+		ProgramHandle program;
+		ShaderHandle vertexShader;
+		ShaderHandle fragmentShader;
+		uint64_t key;
+		bool fromCache;
+		bool done;
+		bool taken;
+	};
+
+	std::vector<Job> jobs;
+
+	bool isReady(const Job& job) const;
+	void complete(Job& job);
+};
+
+#endif
@@ -0,0 +1,85 @@
+#include "shaderVariants.hpp"
+#include "glExt.hpp"
+#include <chrono>
+#include <iostream>
+
+const char* shaderFeatureName(unsigned int bit) {
+	switch (1ull << bit) {
+	case SHADER_SDF_EDGES: return "SDF_EDGES";
+	case SHADER_SHOW_DISTANCE: return "SHOW_DISTANCE";
+	default: return NULL;
+	}
+}
+
+//bits past the known features add no define, they still get their own key
+std::string shaderFeatureDefines(uint64_t features) {
+	std::string defines;
+	for (unsigned int bit = 0; bit < shaderFeatureCount; bit++) {
+		if ((features >> bit) & 1) {
+			defines += "#define ";
+			defines += shaderFeatureName(bit);
+			defines += " 1\n";
+		}
+	}
+	return defines;
+}
+
+ShaderVariants::ShaderVariants(const std::string& vertexSource, const std::string& fragmentSource)
+	: vertexSource(vertexSource), fragmentSource(fragmentSource) {}
+
+void ShaderVariants::prefetch(uint64_t features) {
+	if (variants.count(features) || submitted.count(features)) {
+		return;
+	}
+	submitted[features] = loader.submit(vertexSource, fragmentSource, shaderFeatureDefines(features));
+}
+
+const Shader& ShaderVariants::get(uint64_t features) {
+	std::unordered_map<uint64_t, Shader>::iterator found = variants.find(features);
+	if (found != variants.end()) {
+		return found->second;
+	}
+
+	prefetch(features);
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	Shader shader = loader.take(submitted[features]);
+	submitted.erase(features);
+	std::cout << "Shader variant " << std::hex << features << std::dec
+		<< (shader.fromCache ? " loaded from cache" : " compiled") << ", waited "
+		<< std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() << " ms" << std::endl;
+	return variants.emplace(features, std::move(shader)).first->second;
+}
+
+const Shader* ShaderVariants::ready(uint64_t features) {
+	if (!glExt.parallelShaderCompile) {
+		return &get(features);
+	}
+	std::unordered_map<uint64_t, Shader>::iterator found = variants.find(features);
+	if (found != variants.end()) {
+		return &found->second;
+	}
+	prefetch(features);
+	return NULL;
+}
+
+void ShaderVariants::poll() {
+	if (submitted.empty()) {
+		return;
+	}
+	loader.poll();
+	for (std::unordered_map<uint64_t, unsigned int>::iterator it = submitted.begin(); it != submitted.end();) {
+		if (!loader.done(it->second)) {
+			++it;
+			continue;
+		}
+		Shader shader = loader.take(it->second);
+		std::cout << "Shader variant " << std::hex << it->first << std::dec
+			<< (shader.fromCache ? " loaded from cache" : " compiled") << " in the background" << std::endl;
+		variants.emplace(it->first, std::move(shader));
+		it = submitted.erase(it);
+	}
+}
+
+size_t ShaderVariants::compiled() const {
+	return variants.size();
+}
@@ -0,0 +1,57 @@
+#ifndef SHADERVARIANTS_H
+#define SHADERVARIANTS_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include "shader.hpp"
+#include "shaderLoader.hpp"
+
+/*
+	permutations of one pair of sources, picked by feature bits
+
+	each bit is one #define put right after the #version line, so one set of
+	sources covers every effect instead of a copied file per effect. a variant is
+	compiled the first time it is asked for (or prefetched) and kept under its
+	64 bit feature mask, the defines also feed the on disk program cache key so a
+	variant compiled once is a binary load on the next launch.
+*/
+
+enum ShaderFeature : uint64_t {
+	SHADER_SDF_EDGES = 1ull << 0,		//antialiased rounded box from the corner attribute
+	SHADER_SHOW_DISTANCE = 1ull << 1	//debug view of the distance to the edge (F2)
+};
+
+const unsigned int shaderFeatureCount = 2;
+
+//"#define NAME 1" line per bit set, in bit order
+std::string shaderFeatureDefines(uint64_t features);
+const char* shaderFeatureName(unsigned int bit);
+
+class ShaderVariants {
+public:
+	ShaderVariants(const std::string& vertexSource, const std::string& fragmentSource);
+	ShaderVariants(const ShaderVariants&) = delete;
+	ShaderVariants& operator=(const ShaderVariants&) = delete;
+
+	//submit a variant that will be wanted soon without waiting for it
+	void prefetch(uint64_t features);
+	//the variant, compiled (or waited on) the first time only
+	const Shader& get(uint64_t features);
+	//the variant if it's done, otherwise submits it and returns NULL without waiting.
+	//without GL_KHR_parallel_shader_compile nothing can be asked, so this waits like get
+	const Shader* ready(uint64_t features);
+	//once a frame, keeps the variants that finished compiling since the last call
+	void poll();
+
+	size_t compiled() const;
+
+private:
+	std::string vertexSource;
+	std::string fragmentSource;
+	ShaderLoader loader;
+	std::unordered_map<uint64_t, unsigned int> submitted;
+	std::unordered_map<uint64_t, Shader> variants;
+};
+
+#endif
@@ -0,0 +1,327 @@
+#include "shmTransport.hpp"
+#include <cstring>
+#include <iostream>
+#include <new>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <climits>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#else
+#include <thread>
+#endif
+
+//spins before going to sleep, a step of a small batch is shorter than a syscall
+const unsigned int shmSpinCount = 2000;
+
+//sleeps are bounded so a closed transport is noticed even without a wake
+const long shmWaitNanoseconds = 50 * 1000 * 1000;
+
+static size_t alignSlot(size_t size) {
+	return (size + shmSlotAlignment - 1) / shmSlotAlignment * shmSlotAlignment;
+}
+
+static bool isPowerOfTwo(unsigned int count) {
+	return count && (count & (count - 1)) == 0;
+}
+
+/*
+	FUTEX
+*/
+
+//shared (not private) futexes, the other side is another process
+static void futexWait(std::atomic<uint32_t>& word, uint32_t seen) {
+#ifdef __linux__
+	timespec timeout = { 0, shmWaitNanoseconds };
+	syscall(SYS_futex, (uint32_t*)&word, FUTEX_WAIT, seen, &timeout, NULL, 0);
+#else
+	(void)word;
+	(void)seen;
+	std::this_thread::yield();
+#endif
+}
+
+static void futexWake(std::atomic<uint32_t>& word) {
+#ifdef __linux__
+	syscall(SYS_futex, (uint32_t*)&word, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+#else
+	(void)word;
+#endif
+}
+
+/*
+	RING
+*/
+
+ShmRing::ShmRing() : control(nullptr), slots(nullptr), slotSize(0), slotCount(0), closed(nullptr) {}
+
+void ShmRing::attach(ShmRingControl* control, unsigned char* slots, size_t slotSize, unsigned int slotCount, std::atomic<uint32_t>* closed) {
+	this->control = control;
+	this->slots = slots;
+	this->slotSize = slotSize;
+	this->slotCount = slotCount;
+	this->closed = closed;
+}
+
+//false once closed. waiters is raised before the final check so the other side,
+//which stores the index and then reads waiters, can't miss us (both seq_cst)
+bool ShmRing::wait(std::atomic<uint32_t>& word, uint32_t seen, std::atomic<uint32_t>& waiters) {
+	for (unsigned int spin = 0; spin < shmSpinCount; spin++) {
+		if (word.load(std::memory_order_acquire) != seen) {
+			return true;
+		}
+	}
+	while (!closed->load(std::memory_order_acquire)) {
+		waiters.fetch_add(1);
+		if (word.load() == seen) {
+			futexWait(word, seen);
+		}
+		waiters.fetch_sub(1);
+		if (word.load(std::memory_order_acquire) != seen) {
+			return true;
+		}
+	}
+	return false;
+}
+
+unsigned char* ShmRing::acquireWrite() {
+	uint32_t head = control->head.load(std::memory_order_relaxed);
+	uint32_t tail = control->tail.load(std::memory_order_acquire);
+	while (head - tail >= slotCount) {
+		if (!wait(control->tail, tail, control->writeWaiters)) {
+			return nullptr;
+		}
+		tail = control->tail.load(std::memory_order_acquire);
+	}
+	return slots + (size_t)(head & (slotCount - 1)) * slotSize;
+}
+
+void ShmRing::publishWrite() {
+	control->head.fetch_add(1);
+	if (control->readWaiters.load()) {
+		futexWake(control->head);
+	}
+}
+
+const unsigned char* ShmRing::acquireRead() {
+	uint32_t tail = control->tail.load(std::memory_order_relaxed);
+	uint32_t head = control->head.load(std::memory_order_acquire);
+	while (head == tail) {
+		if (!wait(control->head, head, control->readWaiters)) {
+			return nullptr;
+		}
+		head = control->head.load(std::memory_order_acquire);
+	}
+	return slots + (size_t)(tail & (slotCount - 1)) * slotSize;
+}
+
+void ShmRing::releaseRead() {
+	control->tail.fetch_add(1);
+	if (control->writeWaiters.load()) {
+		futexWake(control->tail);
+	}
+}
+
+void ShmRing::wakeAll() {
+	futexWake(control->head);
+	futexWake(control->tail);
+}
+
+/*
+	TRANSPORT
+*/
+
+ShmTransport::ShmTransport() : header(nullptr), mapping(nullptr), size(0), owner(false) {
+	name[0] = '\0';
+}
+
+ShmTransport::~ShmTransport() {
+	close();
+}
+
+bool ShmTransport::create(const char* name, unsigned int envCount, unsigned int slotCount) {
+#ifdef _WIN32
+	(void)name;
+	(void)envCount;
+	(void)slotCount;
+	std::cout << "Shared memory transport is not supported on this platform" << std::endl;
+	return false;
+#else
+	if (!isPowerOfTwo(slotCount)) {
+		std::cout << "Shared memory slot count " << slotCount << " is not a power of two" << std::endl;
+		return false;
+	}
+	size_t stepSlotSize = alignSlot(envCount * envObservationSize * sizeof(float)) +
+		alignSlot(envCount * sizeof(float)) + alignSlot(envCount);
+	size_t actionSlotSize = alignSlot(envCount);
+	size_t total = alignSlot(sizeof(ShmHeader)) + slotCount * (stepSlotSize + actionSlotSize);
+
+	int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+	if (fd < 0) {
+		std::cout << "Could not create shared memory " << name << std::endl;
+		return false;
+	}
+	if (ftruncate(fd, (off_t)total) != 0) {
+		std::cout << "Could not size shared memory " << name << std::endl;
+		::close(fd);
+		shm_unlink(name);
+		return false;
+	}
+	void* mapped = mmap(NULL, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (mapped == MAP_FAILED) {
+		std::cout << "Could not map shared memory " << name << std::endl;
+		shm_unlink(name);
+		return false;
+	}
+
+	mapping = mapped;
+	size = total;
+	owner = true;
+	strncpy(this->name, name, sizeof(this->name) - 1);
+	this->name[sizeof(this->name) - 1] = '\0';
+
+	//fresh pages are zero, the atomics are constructed in place over them
+	header = new (mapping) ShmHeader();
+	header->envCount = envCount;
+	header->slotCount = slotCount;
+	header->stepSlotSize = stepSlotSize;
+	header->actionSlotSize = actionSlotSize;
+	header->version = shmVersion;
+	layout();
+
+	//magic last, an attaching process that sees it sees everything above
+	std::atomic_thread_fence(std::memory_order_release);
+	header->magic = shmMagic;
+	return true;
+#endif
+}
+
+bool ShmTransport::attach(const char* name) {
+#ifdef _WIN32
+	(void)name;
+	std::cout << "Shared memory transport is not supported on this platform" << std::endl;
+	return false;
+#else
+	int fd = shm_open(name, O_RDWR, 0600);
+	if (fd < 0) {
+		std::cout << "Could not open shared memory " << name << std::endl;
+		return false;
+	}
+	struct stat info;
+	if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(ShmHeader)) {
+		std::cout << name << " is not a transport" << std::endl;
+		::close(fd);
+		return false;
+	}
+	void* mapped = mmap(NULL, (size_t)info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (mapped == MAP_FAILED) {
+		std::cout << "Could not map shared memory " << name << std::endl;
+		return false;
+	}
+
+	mapping = mapped;
+	size = (size_t)info.st_size;
+	owner = false;
+	header = (ShmHeader*)mapping;
+	std::atomic_thread_fence(std::memory_order_acquire);
+	if (header->magic != shmMagic || header->version != shmVersion || !isPowerOfTwo(header->slotCount) ||
+		alignSlot(sizeof(ShmHeader)) + header->slotCount * (header->stepSlotSize + header->actionSlotSize) > size) {
+		std::cout << name << " is not a compatible transport" << std::endl;
+		close();
+		return false;
+	}
+	layout();
+	return true;
+#endif
+}
+
+void ShmTransport::layout() {
+	unsigned char* base = (unsigned char*)mapping + alignSlot(sizeof(ShmHeader));
+	unsigned char* actionBase = base + header->slotCount * header->stepSlotSize;
+	steps.attach(&header->steps, base, (size_t)header->stepSlotSize, header->slotCount, &header->closed);
+	actions.attach(&header->actions, actionBase, (size_t)header->actionSlotSize, header->slotCount, &header->closed);
+}
+
+bool ShmTransport::isOpen() const {
+	return header != nullptr;
+}
+
+StepSlot ShmTransport::stepSlot(unsigned char* slot) const {
+	size_t envCount = header->envCount;
+	StepSlot step;
+	step.observations = (float*)slot;
+	step.rewards = (float*)(slot + alignSlot(envCount * envObservationSize * sizeof(float)));
+	step.dones = (unsigned char*)step.rewards + alignSlot(envCount * sizeof(float));
+	return step;
+}
+
+void ShmTransport::shutdown() {
+	if (!header) {
+		return;
+	}
+	header->closed.store(1);
+	steps.wakeAll();
+	actions.wakeAll();
+}
+
+void ShmTransport::close() {
+#ifndef _WIN32
+	if (mapping) {
+		munmap(mapping, size);
+	}
+	if (owner) {
+		shm_unlink(name);
+	}
+#endif
+	mapping = nullptr;
+	header = nullptr;
+	size = 0;
+	owner = false;
+}
+
+/*
+	SERVER
+*/
+
+unsigned int serveVecEnv(VecEnv& env, ShmTransport& transport) {
+	if (!transport.isOpen() || transport.header->envCount != env.count()) {
+		return 0;
+	}
+
+	unsigned char* slot = transport.steps.acquireWrite();
+	if (!slot) {
+		return 0;
+	}
+	StepSlot step = transport.stepSlot(slot);
+	env.setBuffers(step.observations, step.rewards, step.dones);
+	env.reset();
+	transport.steps.publishWrite();
+
+	unsigned int served = 0;
+	while (true) {
+		const unsigned char* actions = transport.actions.acquireRead();
+		if (!actions) {
+			break;
+		}
+		slot = transport.steps.acquireWrite();
+		if (!slot) {
+			break;
+		}
+		step = transport.stepSlot(slot);
+		env.setBuffers(step.observations, step.rewards, step.dones);
+		env.step(actions);
+		transport.actions.releaseRead();
+		transport.steps.publishWrite();
+		served++;
+	}
+	return served;
+}
@@ -0,0 +1,111 @@
+#ifndef SHMTRANSPORT_H
+#define SHMTRANSPORT_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "vecEnv.hpp"
+
+/*
+	shared memory transport between the simulation and a trainer process
+
+	one shm_open region holds a header and two single producer/single consumer
+	rings: steps (observations, rewards, dones, written by the sim) and actions
+	(written by the trainer). a slot is handed out as a pointer into the mapping,
+	VecEnv writes its outputs straight into it, nothing is serialized or copied.
+	each side spins briefly then sleeps on a futex (linux) on the index it waits
+	for, and the other side only makes the wake syscall when someone is asleep.
+	POSIX only, the windows build reports it as unsupported.
+*/
+
+const uint32_t shmMagic = 0x4D485350;
+const uint32_t shmVersion = 1;
+const unsigned int shmSlotCount = 4;
+const size_t shmSlotAlignment = 64;
+
+//indices only ever grow and wrap at 2^32, slot = index & (slotCount - 1), which is
+//only the right slot across the wrap because slotCount is a power of two. each on its own cache line
+struct ShmRingControl {
+	alignas(64) std::atomic<uint32_t> head;
+	alignas(64) std::atomic<uint32_t> tail;
+	alignas(64) std::atomic<uint32_t> readWaiters;
+	std::atomic<uint32_t> writeWaiters;
+};
+
+struct ShmHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t envCount;
+	uint32_t slotCount;
+	uint64_t stepSlotSize;
+	uint64_t actionSlotSize;
+	std::atomic<uint32_t> closed;
+	ShmRingControl steps;
+	ShmRingControl actions;
+};
+
+//view of one ring inside the mapping
+class ShmRing {
+public:
+	ShmRing();
+	void attach(ShmRingControl* control, unsigned char* slots, size_t slotSize, unsigned int slotCount, std::atomic<uint32_t>* closed);
+
+	//block for a free slot / a filled slot, NULL once the transport is closed
+	unsigned char* acquireWrite();
+	void publishWrite();
+	const unsigned char* acquireRead();
+	void releaseRead();
+
+	void wakeAll();
+
+private:
+	ShmRingControl* control;
+	unsigned char* slots;
+	size_t slotSize;
+	unsigned int slotCount;
+	std::atomic<uint32_t>* closed;
+
+	bool wait(std::atomic<uint32_t>& word, uint32_t seen, std::atomic<uint32_t>& waiters);
+};
+
+//pointers into a step slot
+struct StepSlot {
+	float* observations;
+	float* rewards;
+	unsigned char* dones;
+};
+
+class ShmTransport {
+public:
+	ShmHeader* header;
+	ShmRing steps;
+	ShmRing actions;
+
+	ShmTransport();
+	~ShmTransport();
+	ShmTransport(const ShmTransport&) = delete;
+	ShmTransport& operator=(const ShmTransport&) = delete;
+
+	//the simulation creates the region, the trainer attaches to it by name. slotCount is a power of two
+	bool create(const char* name, unsigned int envCount, unsigned int slotCount = shmSlotCount);
+	bool attach(const char* name);
+	bool isOpen() const;
+	StepSlot stepSlot(unsigned char* slot) const;
+
+	//wakes the other side, which then sees NULL from acquire
+	void shutdown();
+	void close();
+
+private:
+	void* mapping;
+	size_t size;
+	bool owner;
+	char name[64];
+
+	void layout();
+};
+
+//sim side loop, reset then one env step per action slot until the trainer shuts down
+unsigned int serveVecEnv(VecEnv& env, ShmTransport& transport);
+
+#endif
@@ -0,0 +1,180 @@
+#include "simThread.hpp"
+#include "multiBall.hpp"
+#include "net.hpp"
+#include "paddleAI.hpp"
+#include <chrono>
+#include <iostream>
+
+double snapshotAlpha(const RenderSnapshot& snapshot, simClock::time_point now) {
+	double alpha = std::chrono::duration<double>(now - snapshot.tickTime).count() / snapshot.tickDt;
+	return alpha < 0.0 ? 0.0 : (alpha > 1.0 ? 1.0 : alpha);
+}
+
+SimThread::SimThread(PongSim& sim, NetplayPeer* peer, PaddleAI* ai, MultiBall* party)
+	: sim(sim), peer(peer), ai(ai), party(party), running(false),
+	keyButtons(0), heldButtons(0), piecewise(false) {}
+
+SimThread::~SimThread() {
+	stop();
+}
+
+//every slot starts out as the current state so the first read is valid
+void SimThread::start() {
+	if (running.load()) {
+		return;
+	}
+	for (unsigned int i = 0; i < 3; i++) {
+		RenderSnapshot& snapshot = snapshots.slot(i);
+		snapshot.previous = sim.state;
+		snapshot.state = sim.state;
+		snapshot.tickTime = simClock::now();
+		snapshot.publishTime = snapshot.tickTime;
+		snapshot.inputTime = simClock::time_point();
+		snapshot.tickDt = sim.tickDt;
+		snapshot.partyCount = party ? party->count : 0;
+		snapshot.partyPositions.resize(snapshot.partyCount * 2);
+		if (party) {
+			party->writePositions(snapshot.partyPositions.data());
+		}
+	}
+	piecewise = !peer && !sim.tickCallback;
+	tickStart = simClock::now();
+	running.store(true);
+	thread = std::thread(&SimThread::run, this);
+}
+
+void SimThread::stop() {
+	running.store(false);
+	if (thread.joinable()) {
+		thread.join();
+	}
+}
+
+//a full queue drops the event, the next one carries the whole button set again
+simClock::time_point SimThread::keyEvent(unsigned char bit, bool pressed) {
+	keyButtons = pressed ? (keyButtons | bit) : (keyButtons & ~bit);
+	InputEvent event = { simClock::now(), keyButtons };
+	events.push(event);
+	return event.time;
+}
+
+void SimThread::drainEvents() {
+	while (const InputEvent* event = events.peek()) {
+		heldButtons = event->buttons;
+		inputTime = event->time;
+		events.pop();
+	}
+}
+
+//runs every whole tick up to now, cutting each tick into segments at its key events
+unsigned int SimThread::advancePiecewise(simClock::time_point now, unsigned char aiButtons) {
+	const simClock::duration tick = std::chrono::duration_cast<simClock::duration>(std::chrono::duration<double>(sim.tickDt));
+	const simClock::duration maxFrame = std::chrono::duration_cast<simClock::duration>(std::chrono::duration<double>(simMaxFrameTime));
+	const unsigned char keep = ai ? (unsigned char)~(INPUT_RIGHT_UP | INPUT_RIGHT_DOWN) : 0xFF;
+
+	//same spiral guard as PongSim::advance
+	if (now - tickStart > maxFrame) {
+		tickStart = now - maxFrame;
+	}
+
+	unsigned int ticks = 0;
+	while (now - tickStart >= tick) {
+		simClock::time_point tickEnd = tickStart + tick;
+		simClock::time_point segmentStart = tickStart;
+		InputSegment segments[maxInputSegments];
+		unsigned int count = 0;
+
+		//once the segments run out, later events just change the last one
+		while (const InputEvent* event = events.peek()) {
+			if (event->time >= tickEnd) {
+				break;
+			}
+			if (event->time > segmentStart && count < maxInputSegments - 1) {
+				segments[count].buttons = (unsigned char)((heldButtons & keep) | aiButtons);
+				segments[count].duration = std::chrono::duration<double>(event->time - segmentStart).count();
+				count++;
+				segmentStart = event->time;
+			}
+			heldButtons = event->buttons;
+			inputTime = event->time;
+			events.pop();
+		}
+		segments[count].buttons = (unsigned char)((heldButtons & keep) | aiButtons);
+		segments[count].duration = std::chrono::duration<double>(tickEnd - segmentStart).count();
+		count++;
+
+		sim.previous = sim.state;
+		sim.step(segments, count, sim.tickDt);
+		tickStart = tickEnd;
+		ticks++;
+	}
+	sim.accumulator = std::chrono::duration<double>(now - tickStart).count();
+	return ticks;
+}
+
+void SimThread::run() {
+	simClock::time_point last = simClock::now();
+	unsigned int scores[2] = { sim.state.scores[0], sim.state.scores[1] };
+
+	while (running.load()) {
+		simClock::time_point now = simClock::now();
+		double dt = std::chrono::duration<double>(now - last).count();
+		last = now;
+
+		unsigned char aiButtons = ai ? ai->think(sim, (float)dt) : 0;
+
+		unsigned int ticks = 0;
+		if (piecewise) {
+			ticks = advancePiecewise(now, aiButtons);
+		}
+		else {
+			drainEvents();
+			Inputs inputs;
+			inputs.buttons = heldButtons;
+			if (ai) {
+				inputs.buttons = (unsigned char)((inputs.buttons & ~(INPUT_RIGHT_UP | INPUT_RIGHT_DOWN)) | aiButtons);
+			}
+			ticks = peer ? peer->update(dt, inputs.buttons) : sim.advance(inputs, dt);
+		}
+		if (party) {
+			const float partyPaddles[2] = { toFloat(sim.state.paddleY[0]), toFloat(sim.state.paddleY[1]) };
+			for (unsigned int i = 0; i < ticks; i++) {
+				party->step(partyPaddles, (float)sim.tickDt);
+			}
+		}
+
+		if (sim.state.scores[1] != scores[1]) {
+			std::cout << "Right player point" << std::endl;
+		}
+		if (sim.state.scores[0] != scores[0]) {
+			std::cout << "Left player point" << std::endl;
+		}
+		scores[0] = sim.state.scores[0];
+		scores[1] = sim.state.scores[1];
+
+		//sleep off the rest of the tick
+		double banked = peer ? peer->accumulator : sim.accumulator;
+		if (ticks) {
+			publish(now - std::chrono::duration_cast<simClock::duration>(std::chrono::duration<double>(banked)));
+		}
+
+		double wait = sim.tickDt - banked;
+		if (wait > 0.0) {
+			std::this_thread::sleep_until(now + std::chrono::duration_cast<simClock::duration>(std::chrono::duration<double>(wait)));
+		}
+	}
+}
+
+void SimThread::publish(simClock::time_point tickTime) {
+	RenderSnapshot& snapshot = snapshots.write();
+	snapshot.previous = peer ? peer->session.stateAt(sim.state.tick - 1) : sim.previous;
+	snapshot.state = sim.state;
+	snapshot.tickTime = tickTime;
+	snapshot.inputTime = inputTime;
+	snapshot.tickDt = sim.tickDt;
+	if (party) {
+		party->writePositions(snapshot.partyPositions.data());
+	}
+	snapshot.publishTime = simClock::now();
+	snapshots.publish();
+}
@@ -0,0 +1,97 @@
+#ifndef SIMTHREAD_H
+#define SIMTHREAD_H
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "pongSim.hpp"
+#include "spscQueue.hpp"
+#include "tripleBuffer.hpp"
+
+class NetplayPeer;
+class PaddleAI;
+class MultiBall;
+
+/*
+	the simulation on its own thread
+
+	everything that touches PongSim (ai, netplay, recording through tickCallback,
+	party balls) runs here at the sim's tick rate. the render thread only pushes
+	key events and reads the newest snapshot, so a swap that blocks on vsync
+	never holds up a tick and the two rates are independent.
+
+	key events carry the time they arrived. offline and not recording, a tick
+	is split at every event inside it and the paddles move piece by piece, so a
+	press counts from when it happened rather than from the next frame. replays
+	and netplay only carry one input byte per tick, those keep whole tick input.
+*/
+
+typedef std::chrono::steady_clock simClock;
+
+//what the render thread needs from one sim update, immutable once published.
+//tickTime is when the current tick was due, previous is the tick before it.
+//inputTime is the stamp of the newest key event consumed so far
+struct RenderSnapshot {
+	PongState previous;
+	PongState state;
+	simClock::time_point tickTime;
+	simClock::time_point publishTime;
+	simClock::time_point inputTime;
+	double tickDt;
+	std::vector<float> partyPositions;
+	unsigned int partyCount;
+};
+
+//a key went down or up, buttons is everything held from time on
+struct InputEvent {
+	simClock::time_point time;
+	unsigned char buttons;
+};
+
+const unsigned int inputQueueSize = 256;
+const unsigned int maxInputSegments = 16;
+
+//draw one tick behind the sim, alpha of the way from previous to state
+double snapshotAlpha(const RenderSnapshot& snapshot, simClock::time_point now);
+
+class SimThread {
+public:
+	PongSim& sim;
+	NetplayPeer* peer;
+	PaddleAI* ai;
+	MultiBall* party;
+
+	TripleBuffer<RenderSnapshot> snapshots;
+
+	SimThread(PongSim& sim, NetplayPeer* peer = NULL, PaddleAI* ai = NULL, MultiBall* party = NULL);
+	~SimThread();
+	SimThread(const SimThread&) = delete;
+	SimThread& operator=(const SimThread&) = delete;
+
+	void start();
+	void stop();
+
+	//render thread, from the key callback. returns the event's stamp
+	simClock::time_point keyEvent(unsigned char bit, bool pressed);
+
+private:
+	std::thread thread;
+	std::atomic<bool> running;
+	SpscQueue<InputEvent, inputQueueSize> events;
+
+	//producer side (render thread) and consumer side (sim thread) button state
+	unsigned char keyButtons;
+	unsigned char heldButtons;
+	simClock::time_point inputTime;
+
+	bool piecewise;
+	simClock::time_point tickStart;
+
+	void run();
+	void drainEvents();
+	unsigned int advancePiecewise(simClock::time_point now, unsigned char aiButtons);
+	void publish(simClock::time_point tickTime);
+};
+
+#endif
@@ -0,0 +1,164 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <cstring>
+#include "pongBatch.hpp"
+
+/*
+	simd helpers, one set per instruction set so the batch kernels are only written
+	once. lanes follow simdWidth from pongBatch.hpp, only include this from .cpp files
+*/
+
+#if defined(PONGBATCH_AVX2)
+#include <immintrin.h>
+#elif defined(PONGBATCH_SSE2)
+#include <emmintrin.h>
+#endif
+
+#if defined(PONGBATCH_AVX2)
+typedef __m256 vfloat;
+typedef __m256i vint;
+
+static inline vfloat vset(float f) { return _mm256_set1_ps(f); }
+static inline vfloat vload(const float* p) { return _mm256_load_ps(p); }
+static inline void vstore(float* p, vfloat v) { _mm256_store_ps(p, v); }
+static inline vfloat vadd(vfloat a, vfloat b) { return _mm256_add_ps(a, b); }
+static inline vfloat vsub(vfloat a, vfloat b) { return _mm256_sub_ps(a, b); }
+static inline vfloat vmul(vfloat a, vfloat b) { return _mm256_mul_ps(a, b); }
+static inline vfloat vdiv(vfloat a, vfloat b) { return _mm256_div_ps(a, b); }
+static inline vfloat vmax(vfloat a, vfloat b) { return _mm256_max_ps(a, b); }
+static inline vfloat vmin(vfloat a, vfloat b) { return _mm256_min_ps(a, b); }
+static inline vfloat vfloor(vfloat a) { return _mm256_floor_ps(a); }
+static inline vfloat vand(vfloat a, vfloat b) { return _mm256_and_ps(a, b); }
+static inline vfloat vor(vfloat a, vfloat b) { return _mm256_or_ps(a, b); }
+static inline vfloat vandnot(vfloat a, vfloat b) { return _mm256_andnot_ps(a, b); }
+static inline vfloat vxor(vfloat a, vfloat b) { return _mm256_xor_ps(a, b); }
+static inline vfloat vle(vfloat a, vfloat b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+static inline vfloat vlt(vfloat a, vfloat b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+static inline vfloat vge(vfloat a, vfloat b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+static inline vfloat vgt(vfloat a, vfloat b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+static inline vfloat vselect(vfloat mask, vfloat a, vfloat b) { return _mm256_blendv_ps(b, a, mask); }
+static inline int vmovemask(vfloat mask) { return _mm256_movemask_ps(mask); }
+
+//expand 8 button bytes into per lane masks for one bit
+static inline vfloat vbuttons(const unsigned char* buttons, unsigned char bit) {
+	__m128i bytes = _mm_loadl_epi64((const __m128i*)buttons);
+	vint lanes = _mm256_cvtepu8_epi32(bytes);
+	vint bits = _mm256_and_si256(lanes, _mm256_set1_epi32(bit));
+	return _mm256_castsi256_ps(_mm256_cmpeq_epi32(bits, _mm256_set1_epi32(bit)));
+}
+
+static inline void vcount(unsigned int* p, vfloat mask) {
+	vint v = _mm256_load_si256((const vint*)p);
+	_mm256_store_si256((vint*)p, _mm256_sub_epi32(v, _mm256_castps_si256(mask)));
+}
+
+//lane masks to a bit in each 32 bit lane, for building input bytes
+static inline vint vmaskbits(vfloat mask, unsigned char bit) { return _mm256_and_si256(_mm256_castps_si256(mask), _mm256_set1_epi32(bit)); }
+static inline vint vori(vint a, vint b) { return _mm256_or_si256(a, b); }
+
+//narrow 8 lanes (0..255 each) to bytes, p[l] = (p[l] & keep) | lane l
+static inline void vstorebytes(unsigned char* p, vint lanes, unsigned char keep) {
+	__m128i words = _mm_packs_epi32(_mm256_castsi256_si128(lanes), _mm256_extracti128_si256(lanes, 1));
+	__m128i bytes = _mm_packus_epi16(words, words);
+	unsigned long long packed = (unsigned long long)_mm_cvtsi128_si64(bytes);
+	unsigned long long old;
+	memcpy(&old, p, sizeof(old));
+	old = (old & (keep * 0x0101010101010101ull)) | packed;
+	memcpy(p, &old, sizeof(old));
+}
+
+//xorshift32 per lane, returns the new state
+static inline vint vxorshift(unsigned int* p) {
+	vint x = _mm256_load_si256((const vint*)p);
+	x = _mm256_xor_si256(x, _mm256_slli_epi32(x, 13));
+	x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 17));
+	x = _mm256_xor_si256(x, _mm256_slli_epi32(x, 5));
+	_mm256_store_si256((vint*)p, x);
+	return x;
+}
+
+//top 23 bits as the mantissa of [1, 2), then moved to [-1, 1)
+static inline vfloat vsigned(vint bits) {
+	vint mantissa = _mm256_or_si256(_mm256_srli_epi32(bits, 9), _mm256_set1_epi32(0x3F800000));
+	return _mm256_sub_ps(_mm256_mul_ps(_mm256_castsi256_ps(mantissa), _mm256_set1_ps(2.0f)), _mm256_set1_ps(3.0f));
+}
+#elif defined(PONGBATCH_SSE2)
+typedef __m128 vfloat;
+typedef __m128i vint;
+
+static inline vfloat vset(float f) { return _mm_set1_ps(f); }
+static inline vfloat vload(const float* p) { return _mm_load_ps(p); }
+static inline void vstore(float* p, vfloat v) { _mm_store_ps(p, v); }
+static inline vfloat vadd(vfloat a, vfloat b) { return _mm_add_ps(a, b); }
+static inline vfloat vsub(vfloat a, vfloat b) { return _mm_sub_ps(a, b); }
+static inline vfloat vmul(vfloat a, vfloat b) { return _mm_mul_ps(a, b); }
+static inline vfloat vdiv(vfloat a, vfloat b) { return _mm_div_ps(a, b); }
+static inline vfloat vmax(vfloat a, vfloat b) { return _mm_max_ps(a, b); }
+static inline vfloat vmin(vfloat a, vfloat b) { return _mm_min_ps(a, b); }
+
+//no roundps before sse4.1, truncate and step down where that rounded up. from 2^23 up
+//every float is already whole (and cvttps gives 0x80000000 from 2^31), those pass
+//through untouched like floorf, as do inf and nan
+static inline vfloat vfloor(vfloat a) {
+	vfloat t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a));
+	t = _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, a), _mm_set1_ps(1.0f)));
+	vfloat small = _mm_cmplt_ps(_mm_andnot_ps(_mm_set1_ps(-0.0f), a), _mm_set1_ps(8388608.0f));
+	return _mm_or_ps(_mm_and_ps(small, t), _mm_andnot_ps(small, a));
+}
+static inline vfloat vand(vfloat a, vfloat b) { return _mm_and_ps(a, b); }
+static inline vfloat vor(vfloat a, vfloat b) { return _mm_or_ps(a, b); }
+static inline vfloat vandnot(vfloat a, vfloat b) { return _mm_andnot_ps(a, b); }
+static inline vfloat vxor(vfloat a, vfloat b) { return _mm_xor_ps(a, b); }
+static inline vfloat vle(vfloat a, vfloat b) { return _mm_cmple_ps(a, b); }
+static inline vfloat vlt(vfloat a, vfloat b) { return _mm_cmplt_ps(a, b); }
+static inline vfloat vge(vfloat a, vfloat b) { return _mm_cmpge_ps(a, b); }
+static inline vfloat vgt(vfloat a, vfloat b) { return _mm_cmpgt_ps(a, b); }
+static inline vfloat vselect(vfloat mask, vfloat a, vfloat b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+static inline int vmovemask(vfloat mask) { return _mm_movemask_ps(mask); }
+
+//expand 4 button bytes into per lane masks for one bit
+static inline vfloat vbuttons(const unsigned char* buttons, unsigned char bit) {
+	vint lanes = _mm_set_epi32(buttons[3], buttons[2], buttons[1], buttons[0]);
+	vint bits = _mm_and_si128(lanes, _mm_set1_epi32(bit));
+	return _mm_castsi128_ps(_mm_cmpeq_epi32(bits, _mm_set1_epi32(bit)));
+}
+
+static inline void vcount(unsigned int* p, vfloat mask) {
+	vint v = _mm_load_si128((const vint*)p);
+	_mm_store_si128((vint*)p, _mm_sub_epi32(v, _mm_castps_si128(mask)));
+}
+
+//lane masks to a bit in each 32 bit lane, for building input bytes
+static inline vint vmaskbits(vfloat mask, unsigned char bit) { return _mm_and_si128(_mm_castps_si128(mask), _mm_set1_epi32(bit)); }
+static inline vint vori(vint a, vint b) { return _mm_or_si128(a, b); }
+
+//narrow 4 lanes (0..255 each) to bytes, p[l] = (p[l] & keep) | lane l
+static inline void vstorebytes(unsigned char* p, vint lanes, unsigned char keep) {
+	__m128i words = _mm_packs_epi32(lanes, lanes);
+	__m128i bytes = _mm_packus_epi16(words, words);
+	unsigned int packed = (unsigned int)_mm_cvtsi128_si32(bytes);
+	unsigned int old;
+	memcpy(&old, p, sizeof(old));
+	old = (old & (keep * 0x01010101u)) | packed;
+	memcpy(p, &old, sizeof(old));
+}
+
+//xorshift32 per lane, returns the new state
+static inline vint vxorshift(unsigned int* p) {
+	vint x = _mm_load_si128((const vint*)p);
+	x = _mm_xor_si128(x, _mm_slli_epi32(x, 13));
+	x = _mm_xor_si128(x, _mm_srli_epi32(x, 17));
+	x = _mm_xor_si128(x, _mm_slli_epi32(x, 5));
+	_mm_store_si128((vint*)p, x);
+	return x;
+}
+
+//top 23 bits as the mantissa of [1, 2), then moved to [-1, 1)
+static inline vfloat vsigned(vint bits) {
+	vint mantissa = _mm_or_si128(_mm_srli_epi32(bits, 9), _mm_set1_epi32(0x3F800000));
+	return _mm_sub_ps(_mm_mul_ps(_mm_castsi128_ps(mantissa), _mm_set1_ps(2.0f)), _mm_set1_ps(3.0f));
+}
+#endif
+
+#endif
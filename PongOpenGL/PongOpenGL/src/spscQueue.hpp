@@ -0,0 +1,51 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+
+/*
+	lock free single producer/single consumer queue, fixed power of two capacity
+
+	head is only written by the producer and tail only by the consumer, each on
+	its own cache line. push fails instead of blocking when the queue is full.
+*/
+template <typename T, unsigned int Capacity>
+class SpscQueue {
+public:
+	static_assert((Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+	SpscQueue() : head(0), tail(0) {}
+	SpscQueue(const SpscQueue&) = delete;
+	SpscQueue& operator=(const SpscQueue&) = delete;
+
+	//producer side
+	bool push(const T& value) {
+		unsigned int h = head.load(std::memory_order_relaxed);
+		if (h - tail.load(std::memory_order_acquire) >= Capacity) {
+			return false;
+		}
+		items[h & (Capacity - 1)] = value;
+		head.store(h + 1, std::memory_order_release);
+		return true;
+	}
+
+	//consumer side, look at the oldest item without taking it
+	const T* peek() const {
+		unsigned int t = tail.load(std::memory_order_relaxed);
+		if (t == head.load(std::memory_order_acquire)) {
+			return nullptr;
+		}
+		return &items[t & (Capacity - 1)];
+	}
+
+	void pop() {
+		tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+private:
+	T items[Capacity];
+	alignas(64) std::atomic<unsigned int> head;
+	alignas(64) std::atomic<unsigned int> tail;
+};
+
+#endif
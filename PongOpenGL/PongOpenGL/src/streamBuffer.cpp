@@ -0,0 +1,181 @@
+#include "streamBuffer.hpp"
+#include "glExt.hpp"
+#include <cstring>
+
+const GLbitfield persistentFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+StreamMode bestStreamMode() {
+	return glExt.bufferStorage ? STREAM_PERSISTENT : STREAM_UNSYNCHRONIZED;
+}
+
+const char* streamModeName(StreamMode mode) {
+	switch (mode) {
+	case STREAM_PERSISTENT: return "persistent";
+	case STREAM_UNSYNCHRONIZED: return "unsync";
+	case STREAM_ORPHAN: return "orphan";
+	case STREAM_SUBDATA: return "subdata";
+	default: return "?";
+	}
+}
+
+bool parseStreamMode(const char* name, StreamMode& mode) {
+	for (unsigned int i = 0; i < STREAM_MODE_COUNT; i++) {
+		if (strcmp(name, streamModeName((StreamMode)i)) == 0) {
+			mode = (StreamMode)i;
+			return true;
+		}
+	}
+	return false;
+}
+
+//persistent needs buffer storage, asking for it without falls back to unsynchronized
+StreamBuffer::StreamBuffer(GLsizeiptr regionSize, StreamMode mode)
+	: bufferObj(), mode(mode == STREAM_PERSISTENT && !glExt.bufferStorage ? STREAM_UNSYNCHRONIZED : mode),
+	regionSize(0), regionCount(1), region(0), waits(0), persistent(NULL), written(false), rangeMapped(false) {
+	for (unsigned int i = 0; i < streamRegions; i++) {
+		fences[i] = 0;
+	}
+	regionCount = this->mode == STREAM_PERSISTENT || this->mode == STREAM_UNSYNCHRONIZED ? streamRegions : 1;
+	allocate(regionSize > 0 ? regionSize : 1);
+}
+
+StreamBuffer::~StreamBuffer() {
+	release();
+}
+
+//a fresh buffer name, the old one is deleted at the end of the frame
+void StreamBuffer::allocate(GLsizeiptr regionSize) {
+	release();
+	this->regionSize = regionSize;
+	region = 0;
+
+	GLuint name;
+	glGenBuffers(1, &name);
+	bufferObj.reset(name);
+	glStateBindBuffer(GL_ARRAY_BUFFER, bufferObj);
+	if (mode == STREAM_PERSISTENT) {
+		glExtBufferStorage(GL_ARRAY_BUFFER, regionSize * regionCount, NULL, persistentFlags);
+		persistent = (unsigned char*)glMapBufferRange(GL_ARRAY_BUFFER, 0, regionSize * regionCount, persistentFlags);
+	}
+	else {
+		glBufferData(GL_ARRAY_BUFFER, regionSize * regionCount, NULL, GL_STREAM_DRAW);
+	}
+}
+
+//no gl calls, safe from the destructor. deleting a buffer unmaps it
+void StreamBuffer::release() {
+	for (unsigned int i = 0; i < streamRegions; i++) {
+		if (fences[i]) {
+			glDeferDeleteSync(fences[i]);
+			fences[i] = 0;
+		}
+	}
+	persistent = NULL;
+	rangeMapped = false;
+	bufferObj.reset();
+}
+
+//block until the gpu is done with the region we are about to overwrite
+void StreamBuffer::waitRegion() {
+	GLsync& regionFence = fences[region];
+	if (!regionFence) {
+		return;
+	}
+	if (glClientWaitSync(regionFence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+		waits++;
+		GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+		while (glClientWaitSync(regionFence, flags, 1000 * 1000 * 1000) == GL_TIMEOUT_EXPIRED) {
+			flags = 0;
+		}
+	}
+	glDeleteSync(regionFence);
+	regionFence = 0;
+}
+
+void* StreamBuffer::map(GLsizeiptr size) {
+	if (size > regionSize) {
+		GLsizeiptr grown = regionSize;
+		while (grown < size) {
+			grown *= 2;
+		}
+		allocate(grown);
+	}
+	written = true;
+
+	switch (mode) {
+	case STREAM_PERSISTENT:
+		waitRegion();
+		return persistent ? persistent + region * regionSize : NULL;
+	case STREAM_UNSYNCHRONIZED: {
+		waitRegion();
+		glStateBindBuffer(GL_ARRAY_BUFFER, bufferObj);
+		void* range = glMapBufferRange(GL_ARRAY_BUFFER, region * regionSize, size,
+			GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+		rangeMapped = range != NULL;
+		return range;
+	}
+	default:
+		staging.resize((size_t)size);
+		return staging.data();
+	}
+}
+
+GLintptr StreamBuffer::commit(GLsizeiptr size) {
+	glStateBindBuffer(GL_ARRAY_BUFFER, bufferObj);
+	switch (mode) {
+	case STREAM_PERSISTENT:
+		//coherent, later gl commands see the writes without a flush
+		break;
+	case STREAM_UNSYNCHRONIZED:
+		//unmapping a buffer that isn't mapped is a GL_INVALID_OPERATION
+		if (rangeMapped) {
+			glUnmapBuffer(GL_ARRAY_BUFFER);
+			rangeMapped = false;
+		}
+		break;
+	case STREAM_ORPHAN:
+		glBufferData(GL_ARRAY_BUFFER, regionSize, NULL, GL_STREAM_DRAW);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, size, staging.data());
+		break;
+	default:
+		glBufferSubData(GL_ARRAY_BUFFER, 0, size, staging.data());
+		break;
+	}
+	return region * regionSize;
+}
+
+GLintptr StreamBuffer::upload(const void* data, GLsizeiptr size) {
+	void* destination = map(size);
+	if (destination) {
+		memcpy(destination, data, (size_t)size);
+	}
+	return commit(size);
+}
+
+void StreamBuffer::fence() {
+	if (!written) {
+		return;
+	}
+	written = false;
+	if (regionCount > 1) {
+		fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		region = (region + 1) % regionCount;
+	}
+}
+
+void StreamBuffer::LinkAttri(GLuint layout, GLuint numComponents, GLenum type, GLboolean normalized, GLsizeiptr stride, GLintptr offset) {
+	glStateBindBuffer(GL_ARRAY_BUFFER, bufferObj);
+	glVertexAttribPointer(layout, numComponents, type, normalized, (GLsizei)stride, (void*)offset);
+}
+
+void StreamBuffer::Bind() {
+	glStateBindBuffer(GL_ARRAY_BUFFER, bufferObj);
+}
+
+void StreamBuffer::Unbind() {
+	glStateBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void StreamBuffer::Delete() {
+	release();
+}
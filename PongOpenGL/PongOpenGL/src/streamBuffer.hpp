@@ -0,0 +1,81 @@
+#ifndef STREAMBUFFER_H
+#define STREAMBUFFER_H
+
+#include <glad/glad.h>
+#include "glHandle.hpp"
+#include "glState.hpp"
+#include <vector>
+
+enum StreamMode {
+	STREAM_PERSISTENT,		//buffer storage mapped once, persistent and coherent, fenced regions
+	STREAM_UNSYNCHRONIZED,	//glMapBufferRange unsynchronized every frame, fenced regions
+	STREAM_ORPHAN,			//glBufferData(NULL) then glBufferSubData
+	STREAM_SUBDATA,			//plain glBufferSubData, syncs if the gpu still reads the old data
+	STREAM_MODE_COUNT
+};
+
+//frames of data in flight for the fenced modes
+const unsigned int streamRegions = 3;
+
+/*
+	per frame upload buffer for instance data
+
+	the fenced modes split the buffer into streamRegions regions and write the
+	next one each frame, the fence placed after the frame's draws is only waited
+	on when the gpu falls that many frames behind, so an upload never stalls on
+	a draw still reading last frame's data. orphan and subdata keep one region
+	and leave the syncing to the driver, they're the 3.3 fallbacks and the
+	baseline for --bench-stream.
+
+	one map/commit per frame, then fence after the draws that read it. the
+	returned offset moves every frame, attributes are pointed at it with LinkAttri.
+*/
+class StreamBuffer {
+public:
+	BufferHandle bufferObj;
+	StreamMode mode;
+	GLsizeiptr regionSize;
+	unsigned int regionCount;
+	unsigned int region;
+	//times map had to block on the gpu
+	unsigned int waits;
+
+	StreamBuffer(GLsizeiptr regionSize, StreamMode mode);
+	~StreamBuffer();
+	StreamBuffer(const StreamBuffer&) = delete;
+	StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+	//size bytes to fill for this frame, the region grows if it is too small. NULL if gl couldn't map it
+	void* map(GLsizeiptr size);
+	//hands the written bytes to gl, returns their offset in the buffer. only unmaps what map mapped
+	GLintptr commit(GLsizeiptr size);
+	GLintptr upload(const void* data, GLsizeiptr size);
+	//after the draws reading this frame's data, moves to the next region
+	void fence();
+
+	//with the vao bound, again every frame with commit's offset
+	void LinkAttri(GLuint layout, GLuint numComponents, GLenum type, GLboolean normalized, GLsizeiptr stride, GLintptr offset);
+	void Bind();
+	void Unbind();
+	void Delete();
+
+private:
+	unsigned char* persistent;
+	std::vector<unsigned char> staging;
+	GLsync fences[streamRegions];
+	bool written;
+	//unsynchronized mode has a range mapped that commit has to unmap
+	bool rangeMapped;
+
+	void allocate(GLsizeiptr regionSize);
+	void release();
+	void waitRegion();
+};
+
+//persistent when the context has buffer storage, unsynchronized otherwise
+StreamMode bestStreamMode();
+const char* streamModeName(StreamMode mode);
+//from the command line name, false if unknown
+bool parseStreamMode(const char* name, StreamMode& mode);
+
+#endif
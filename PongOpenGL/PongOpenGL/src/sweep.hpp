@@ -0,0 +1,155 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include "fixed.hpp"
+
+/*
+	swept circle against box, templated on the number type so PongSim can run it
+	in fixed point while MultiBall stays on floats
+*/
+
+//earliest contact found by a sweep, paddle is -1 for walls
+template <typename Scalar>
+struct SweepHit {
+	Scalar t;
+	Scalar nx;
+	Scalar ny;
+	int paddle;
+};
+
+//time of impact of a moving circle against a box grown by the radius (rounded corners),
+//only counts contacts where the circle is moving into the surface
+template <typename Scalar>
+bool sweepCircleBox(Scalar px, Scalar py, Scalar vx, Scalar vy, Scalar radius,
+	Scalar cx, Scalar cy, Scalar hx, Scalar hy, Scalar maxT, SweepHit<Scalar>& hit) {
+	const Scalar zero = Scalar(0);
+	const Scalar one = Scalar(1);
+
+	Scalar rx = px - cx;
+	Scalar ry = py - cy;
+	Scalar ex = hx + radius;
+	Scalar ey = hy + radius;
+
+	//already touching, e.g. the paddle moved onto the ball
+	Scalar ox = scalarAbs(rx) - hx;
+	Scalar oy = scalarAbs(ry) - hy;
+	if (ox <= radius && oy <= radius) {
+		Scalar nx = zero;
+		Scalar ny = zero;
+		if (ox > zero && oy > zero) {
+			if (ox * ox + oy * oy <= radius * radius) {
+				Scalar len = scalarSqrt(ox * ox + oy * oy);
+				if (len == zero) {
+					//offsets this small square to 0 (below 2^-8 in fixed point), push out along the larger one
+					nx = ox >= oy ? (rx < zero ? -one : one) : zero;
+					ny = ox >= oy ? zero : (ry < zero ? -one : one);
+				}
+				else {
+					nx = rx < zero ? -ox / len : ox / len;
+					ny = ry < zero ? -oy / len : oy / len;
+				}
+			}
+		}
+		else if (ox >= oy) {
+			nx = rx < zero ? -one : one;
+		}
+		else {
+			ny = ry < zero ? -one : one;
+		}
+		if ((nx != zero || ny != zero) && vx * nx + vy * ny < zero) {
+			hit.t = zero;
+			hit.nx = nx;
+			hit.ny = ny;
+			return true;
+		}
+		if (nx != zero || ny != zero) {
+			return false;
+		}
+	}
+
+	//slabs of the grown box
+	Scalar tEnter = zero;
+	Scalar tExit = maxT;
+	Scalar nx = zero;
+	Scalar ny = zero;
+	if (vx == zero) {
+		if (scalarAbs(rx) > ex) {
+			return false;
+		}
+	}
+	else {
+		Scalar t0 = (-ex - rx) / vx;
+		Scalar t1 = (ex - rx) / vx;
+		Scalar n = -one;
+		if (t0 > t1) {
+			Scalar tmp = t0;
+			t0 = t1;
+			t1 = tmp;
+			n = one;
+		}
+		if (t0 > tEnter) {
+			tEnter = t0;
+			nx = n;
+		}
+		tExit = t1 < tExit ? t1 : tExit;
+	}
+	if (vy == zero) {
+		if (scalarAbs(ry) > ey) {
+			return false;
+		}
+	}
+	else {
+		Scalar t0 = (-ey - ry) / vy;
+		Scalar t1 = (ey - ry) / vy;
+		Scalar n = -one;
+		if (t0 > t1) {
+			Scalar tmp = t0;
+			t0 = t1;
+			t1 = tmp;
+			n = one;
+		}
+		if (t0 > tEnter) {
+			tEnter = t0;
+			nx = zero;
+			ny = n;
+		}
+		tExit = t1 < tExit ? t1 : tExit;
+	}
+	if (tEnter > tExit) {
+		return false;
+	}
+
+	//entry point on a flat face, starting inside the grown box means we are in a corner gap
+	Scalar qx = rx + vx * tEnter;
+	Scalar qy = ry + vy * tEnter;
+	if ((nx != zero || ny != zero) && (scalarAbs(qx) <= hx || scalarAbs(qy) <= hy)) {
+		hit.t = tEnter;
+		hit.nx = nx;
+		hit.ny = ny;
+		return true;
+	}
+
+	//entry point in a corner square, intersect with the corner circle instead
+	Scalar kx = qx < zero ? -hx : hx;
+	Scalar ky = qy < zero ? -hy : hy;
+	Scalar dx = rx - kx;
+	Scalar dy = ry - ky;
+	Scalar a = vx * vx + vy * vy;
+	Scalar b = dx * vx + dy * vy;
+	Scalar c = dx * dx + dy * dy - radius * radius;
+	Scalar disc = b * b - a * c;
+	if (b >= zero || disc < zero) {
+		return false;
+	}
+	Scalar t = (-b - scalarSqrt(disc)) / a;
+	if (t < zero || t > maxT) {
+		return false;
+	}
+	hit.t = t;
+	hit.nx = (dx + vx * t) / radius;
+	hit.ny = (dy + vy * t) / radius;
+	return true;
+}
+
+#endif
+
@@ -0,0 +1,209 @@
+#include "threadPool.hpp"
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+//stick the calling thread to one hardware thread, no-op where unsupported
+void pinCurrentThread(unsigned int core) {
+	unsigned int cores = std::thread::hardware_concurrency();
+	if (cores > 0) {
+		core %= cores;
+	}
+#if defined(_WIN32)
+	SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << (core % (sizeof(DWORD_PTR) * 8)));
+#elif defined(__linux__)
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(core % CPU_SETSIZE, &set);
+	pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+}
+
+struct ThreadPool::Affinity {
+#if defined(_WIN32)
+	DWORD_PTR mask;
+#elif defined(__linux__)
+	cpu_set_t set;
+#endif
+};
+
+//the calling thread's affinity, so a pool that pinned it can put it back
+void ThreadPool::saveAffinity(Affinity& saved) {
+#if defined(_WIN32)
+	//windows only hands the old mask back from a set, set the process mask to read it
+	DWORD_PTR process = 0;
+	DWORD_PTR system = 0;
+	GetProcessAffinityMask(GetCurrentProcess(), &process, &system);
+	saved.mask = SetThreadAffinityMask(GetCurrentThread(), process);
+#elif defined(__linux__)
+	if (pthread_getaffinity_np(pthread_self(), sizeof(saved.set), &saved.set) != 0) {
+		CPU_ZERO(&saved.set);
+	}
+#else
+	(void)saved;
+#endif
+}
+
+void ThreadPool::restoreAffinity(const Affinity& saved) {
+#if defined(_WIN32)
+	if (saved.mask) {
+		SetThreadAffinityMask(GetCurrentThread(), saved.mask);
+	}
+#elif defined(__linux__)
+	if (CPU_COUNT(&saved.set) > 0) {
+		pthread_setaffinity_np(pthread_self(), sizeof(saved.set), &saved.set);
+	}
+#else
+	(void)saved;
+#endif
+}
+
+ThreadPool::ThreadPool(unsigned int numThreads, bool pinThreads)
+	: job(nullptr), pending(0), quit(false), generation(0) {
+	if (numThreads == 0) {
+		numThreads = std::thread::hardware_concurrency();
+	}
+	if (numThreads == 0) {
+		numThreads = 1;
+	}
+
+	for (unsigned int i = 0; i < numThreads; i++) {
+		workers.push_back(std::unique_ptr<Worker>(new Worker()));
+	}
+
+	//worker 0 is whoever calls parallelFor, it gets its old affinity back in the destructor
+	if (pinThreads) {
+		callerAffinity.reset(new Affinity());
+		saveAffinity(*callerAffinity);
+		pinCurrentThread(0);
+	}
+	for (unsigned int i = 1; i < numThreads; i++) {
+		workers[i]->thread = std::thread(&ThreadPool::workerLoop, this, i, pinThreads);
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	quit = true;
+	{
+		std::lock_guard<std::mutex> lk(wakeLock);
+		generation++;
+	}
+	wake.notify_all();
+
+	for (unsigned int i = 1; i < workers.size(); i++) {
+		workers[i]->thread.join();
+	}
+
+	if (callerAffinity) {
+		restoreAffinity(*callerAffinity);
+	}
+}
+
+unsigned int ThreadPool::size() const {
+	return (unsigned int)workers.size();
+}
+
+//own work comes off the back, most recently pushed so still warm
+bool ThreadPool::pop(unsigned int self, Range& range) {
+	Worker& worker = *workers[self];
+	std::lock_guard<std::mutex> lk(worker.lock);
+	if (worker.tasks.empty()) {
+		return false;
+	}
+	range = worker.tasks.back();
+	worker.tasks.pop_back();
+	return true;
+}
+
+//stolen work comes off the front of the next worker that has any
+bool ThreadPool::steal(unsigned int self, Range& range) {
+	unsigned int n = (unsigned int)workers.size();
+	for (unsigned int i = 1; i < n; i++) {
+		Worker& victim = *workers[(self + i) % n];
+		std::lock_guard<std::mutex> lk(victim.lock);
+		if (!victim.tasks.empty()) {
+			range = victim.tasks.front();
+			victim.tasks.pop_front();
+			return true;
+		}
+	}
+	return false;
+}
+
+bool ThreadPool::runOne(unsigned int self) {
+	Range range;
+	if (!pop(self, range) && !steal(self, range)) {
+		return false;
+	}
+	(*job)(range.begin, range.end);
+	pending.fetch_sub(1, std::memory_order_release);
+	return true;
+}
+
+void ThreadPool::workerLoop(unsigned int self, bool pin) {
+	if (pin) {
+		pinCurrentThread(self);
+	}
+
+	unsigned int seen = 0;
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lk(wakeLock);
+			wake.wait(lk, [&] { return generation != seen; });
+			seen = generation;
+		}
+		if (quit) {
+			return;
+		}
+
+		while (pending.load(std::memory_order_acquire) > 0) {
+			if (!runOne(self)) {
+				std::this_thread::yield();
+			}
+		}
+	}
+}
+
+//runs function over [begin, end) in chunk sized pieces, returns once every piece is done
+void ThreadPool::parallelFor(unsigned int begin, unsigned int end, unsigned int chunk, const RangeFunction& function) {
+	if (end <= begin) {
+		return;
+	}
+	chunk = chunk ? chunk : 1;
+	unsigned int numChunks = (end - begin + chunk - 1) / chunk;
+	unsigned int n = (unsigned int)workers.size();
+	if (n == 1 || numChunks == 1) {
+		function(begin, end);
+		return;
+	}
+
+	job = &function;
+	pending.store(numChunks, std::memory_order_relaxed);
+
+	//neighbouring chunks go to the same worker so each one walks contiguous memory
+	unsigned int perWorker = (numChunks + n - 1) / n;
+	for (unsigned int c = 0; c < numChunks; c++) {
+		Range range = { begin + c * chunk, begin + (c + 1) * chunk };
+		range.end = range.end < end ? range.end : end;
+		Worker& worker = *workers[c / perWorker];
+		std::lock_guard<std::mutex> lk(worker.lock);
+		worker.tasks.push_front(range);
+	}
+
+	{
+		std::lock_guard<std::mutex> lk(wakeLock);
+		generation++;
+	}
+	wake.notify_all();
+
+	while (pending.load(std::memory_order_acquire) > 0) {
+		if (!runOne(0)) {
+			std::this_thread::yield();
+		}
+	}
+}
@@ -0,0 +1,72 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+	work stealing pool for splitting a range of independent work (batches of matches)
+
+	parallelFor cuts the range into chunks and deals them out to per thread deques.
+	owners pop from the back, idle threads steal from the front of someone else's.
+	completion is a single atomic count of unfinished chunks that the calling
+	thread (which also works) spins on, no barrier between the workers.
+*/
+class ThreadPool {
+public:
+	typedef std::function<void(unsigned int begin, unsigned int end)> RangeFunction;
+
+	//0 threads means one per hardware thread, the caller counts as one of them.
+	//pinning pins the constructing thread too, until the pool is destroyed (on that same thread)
+	ThreadPool(unsigned int numThreads = 0, bool pinThreads = false);
+	~ThreadPool();
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	unsigned int size() const;
+	void parallelFor(unsigned int begin, unsigned int end, unsigned int chunk, const RangeFunction& function);
+
+private:
+	struct Range {
+		unsigned int begin;
+		unsigned int end;
+	};
+
+	struct Worker {
+		std::mutex lock;
+		std::deque<Range> tasks;
+		std::thread thread;
+	};
+
+	//platform affinity mask, defined in the cpp
+	struct Affinity;
+
+	std::vector<std::unique_ptr<Worker>> workers;
+	//what the constructing thread ran on before it was pinned, NULL if it wasn't
+	std::unique_ptr<Affinity> callerAffinity;
+	const RangeFunction* job;
+	std::atomic<unsigned int> pending;
+	std::atomic<bool> quit;
+
+	//sleeping between jobs
+	std::mutex wakeLock;
+	std::condition_variable wake;
+	unsigned int generation;
+
+	bool pop(unsigned int self, Range& range);
+	bool steal(unsigned int self, Range& range);
+	bool runOne(unsigned int self);
+	void workerLoop(unsigned int self, bool pin);
+	static void saveAffinity(Affinity& saved);
+	static void restoreAffinity(const Affinity& saved);
+};
+
+void pinCurrentThread(unsigned int core);
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+
+/*
+	lock free triple buffer, one writer thread and one reader thread
+
+	the writer fills its back slot and publishes it by swapping it with the
+	middle slot, the reader swaps the middle slot into its front slot when a new
+	one was published. neither side ever waits, the reader always sees the newest
+	complete value and a slot is never written while it is being read.
+*/
+template <typename T>
+class TripleBuffer {
+public:
+	TripleBuffer() : middle(1), back(2), front(0) {}
+	TripleBuffer(const TripleBuffer&) = delete;
+	TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+	//writer side
+	T& write() {
+		return slots[back].value;
+	}
+
+	void publish() {
+		back = middle.exchange(back | freshBit, std::memory_order_acq_rel) & indexMask;
+	}
+
+	//reader side, the returned slot stays untouched until the next read
+	const T& read() {
+		if (middle.load(std::memory_order_relaxed) & freshBit) {
+			front = middle.exchange(front, std::memory_order_acq_rel) & indexMask;
+		}
+		return slots[front].value;
+	}
+
+	bool hasNew() const {
+		return (middle.load(std::memory_order_relaxed) & freshBit) != 0;
+	}
+
+	//before the threads start, e.g. to size vectors in every slot
+	T& slot(unsigned int i) {
+		return slots[i].value;
+	}
+
+private:
+	static const unsigned char indexMask = 3;
+	static const unsigned char freshBit = 4;
+
+	//own cache lines so the two threads don't false share
+	struct alignas(64) Slot {
+		T value;
+	};
+
+	Slot slots[3];
+	alignas(64) std::atomic<unsigned char> middle;
+	alignas(64) unsigned char back;
+	alignas(64) unsigned char front;
+};
+
+#endif
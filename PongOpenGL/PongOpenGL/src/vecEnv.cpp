@@ -0,0 +1,60 @@
+#include "vecEnv.hpp"
+
+VecEnv::VecEnv(unsigned int count, float width, float height, double tickRate)
+	: batch(count, width, height), opponent(batch, 1), dt((float)(1.0 / tickRate)),
+	observations(NULL), rewards(NULL), dones(NULL), buttons(batch.capacity, 0) {}
+
+unsigned int VecEnv::count() const {
+	return batch.count;
+}
+
+void VecEnv::setBuffers(float* observations, float* rewards, unsigned char* dones) {
+	this->observations = observations;
+	this->rewards = rewards;
+	this->dones = dones;
+}
+
+void VecEnv::reset(const unsigned char* mask) {
+	for (unsigned int i = 0; i < batch.count; i++) {
+		if (mask && !mask[i]) {
+			continue;
+		}
+		batch.reset(i);
+		opponent.reset(batch, i);
+		rewards[i] = 0.0f;
+		dones[i] = 0;
+	}
+	observe();
+}
+
+void VecEnv::step(const unsigned char* actions) {
+	//padding lanes keep stepping with no input, nothing reads them
+	for (unsigned int i = 0; i < batch.count; i++) {
+		buttons[i] = actions[i] == ACTION_UP ? INPUT_LEFT_UP : (actions[i] == ACTION_DOWN ? INPUT_LEFT_DOWN : 0);
+	}
+	opponent.think(batch, dt, buttons.data());
+	batch.step(buttons.data(), dt);
+
+	for (unsigned int i = 0; i < batch.count; i++) {
+		unsigned char point = batch.points[i];
+		rewards[i] = point == POINT_LEFT ? 1.0f : (point == POINT_RIGHT ? -1.0f : 0.0f);
+		dones[i] = point != POINT_NONE;
+	}
+	observe();
+}
+
+//SoA batch to one row per env, positions in [-1, 1] and velocities in paddle speeds
+void VecEnv::observe() {
+	const float scaleX = 2.0f / batch.width;
+	const float scaleY = 2.0f / batch.height;
+	const float scaleV = 1.0f / paddleSpeed;
+	for (unsigned int i = 0; i < batch.count; i++) {
+		float* row = observations + (size_t)i * envObservationSize;
+		row[0] = batch.ballX[i] * scaleX - 1.0f;
+		row[1] = batch.ballY[i] * scaleY - 1.0f;
+		row[2] = batch.ballVX[i] * scaleV;
+		row[3] = batch.ballVY[i] * scaleV;
+		row[4] = batch.paddleY[0][i] * scaleY - 1.0f;
+		row[5] = batch.paddleY[1][i] * scaleY - 1.0f;
+	}
+}
@@ -0,0 +1,55 @@
+#ifndef VECENV_H
+#define VECENV_H
+
+#include <vector>
+#include "pongBatch.hpp"
+#include "paddleAI.hpp"
+
+/*
+	gym style vectorized environment for training, the agent plays the left paddle
+	against BatchAI on the right
+
+	the caller owns the output buffers and hands them over once with setBuffers,
+	reset and step write straight into them and never allocate. observations are
+	[count][envObservationSize] floats, rewards [count] floats, dones [count] bytes.
+	a point ends the episode, the batch has already put the ball back in the
+	middle like PongSim does, so the observation written for a done env is the
+	first one of its next episode (auto reset).
+*/
+
+enum EnvAction : unsigned char {
+	ACTION_STAY = 0,
+	ACTION_UP = 1,
+	ACTION_DOWN = 2
+};
+
+//ball x, y, vx, vy, own paddle y, opponent paddle y
+const unsigned int envObservationSize = 6;
+
+class VecEnv {
+public:
+	PongBatch batch;
+	BatchAI opponent;
+	float dt;
+
+	VecEnv(unsigned int count, float width, float height, double tickRate = simTickRate);
+
+	unsigned int count() const;
+	void setBuffers(float* observations, float* rewards, unsigned char* dones);
+
+	//mask has count entries, non zero resets that env, NULL resets all of them
+	void reset(const unsigned char* mask = NULL);
+
+	//actions has count EnvAction entries
+	void step(const unsigned char* actions);
+
+private:
+	float* observations;
+	float* rewards;
+	unsigned char* dones;
+	std::vector<unsigned char> buttons;
+
+	void observe();
+};
+
+#endif
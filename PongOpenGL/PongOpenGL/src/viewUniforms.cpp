@@ -0,0 +1,54 @@
+#include "viewUniforms.hpp"
+#include "glState.hpp"
+
+void orthographicProjection(GLfloat out[16],
+	float left, float right,
+	float bottom, float top,
+	float near, float far) {
+	const GLfloat mat[16] = {
+		2.0f / (right - left), 0.0f, 0.0f, 0.0f,
+		0.0f, 2.0f / (top - bottom), 0.0f, 0.0f,
+		0.0f, 0.0f, -2.0f / (far - near), 0.0f,
+		-(right + left) / (right - left), -(top + bottom) / (top - bottom), -(far + near) / (far - near), 1.0f
+	};
+	for (int i = 0; i < 16; i++) {
+		out[i] = mat[i];
+	}
+}
+
+ViewUniforms::ViewUniforms(GLfloat fieldWidth, GLfloat fieldHeight)
+	: fieldWidth(fieldWidth), fieldHeight(fieldHeight), block() {
+	orthographicProjection(block.projection, 0.0f, fieldWidth, 0.0f, fieldHeight, 0.0f, 1.0f);
+
+	GLuint name;
+	glGenBuffers(1, &name);
+	uboObj.reset(name);
+	glStateBindBuffer(GL_UNIFORM_BUFFER, uboObj);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(ViewBlock), &block, GL_DYNAMIC_DRAW);
+	glStateBindBufferBase(GL_UNIFORM_BUFFER, viewBlockBinding, uboObj);
+}
+
+void ViewUniforms::resize(int width, int height) {
+	if (width <= 0 || height <= 0) {
+		return;
+	}
+
+	//largest rectangle of the field's shape that fits, centred
+	GLfloat scale = (GLfloat)width / fieldWidth;
+	if (fieldHeight * scale > (GLfloat)height) {
+		scale = (GLfloat)height / fieldHeight;
+	}
+	GLint viewWidth = (GLint)(fieldWidth * scale + 0.5f);
+	GLint viewHeight = (GLint)(fieldHeight * scale + 0.5f);
+	GLint viewX = (width - viewWidth) / 2;
+	GLint viewY = (height - viewHeight) / 2;
+	glViewport(viewX, viewY, viewWidth, viewHeight);
+
+	block.viewport[0] = (GLfloat)viewX;
+	block.viewport[1] = (GLfloat)viewY;
+	block.viewport[2] = (GLfloat)viewWidth;
+	block.viewport[3] = (GLfloat)viewHeight;
+
+	glStateBindBuffer(GL_UNIFORM_BUFFER, uboObj);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(ViewBlock), &block);
+}
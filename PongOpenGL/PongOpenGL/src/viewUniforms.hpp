@@ -0,0 +1,44 @@
+#ifndef VIEWUNIFORMS_H
+#define VIEWUNIFORMS_H
+
+#include <glad/glad.h>
+#include "glHandle.hpp"
+
+//every program's View block is pointed here when it is linked (see Shader)
+const GLuint viewBlockBinding = 0;
+const char* const viewBlockName = "View";
+
+//std140 layout of the View block, mat4 then vec4 needs no padding
+struct ViewBlock {
+	GLfloat projection[16];
+	GLfloat viewport[4];	//x, y, width, height in framebuffer pixels
+};
+static_assert(sizeof(ViewBlock) == 80, "ViewBlock must match the std140 View block");
+
+/*
+	per view uniforms in one buffer shared by every program
+
+	the field is always fieldWidth x fieldHeight units, a framebuffer of another
+	shape gets it letterboxed. only resize writes the buffer, so drawing with
+	more programs costs no extra uniform uploads.
+*/
+class ViewUniforms {
+public:
+	BufferHandle uboObj;
+	GLfloat fieldWidth;
+	GLfloat fieldHeight;
+	ViewBlock block;
+
+	ViewUniforms(GLfloat fieldWidth, GLfloat fieldHeight);
+
+	//framebuffer size in pixels, sets the viewport too. 0 sized (minimized) is ignored
+	void resize(int width, int height);
+};
+
+//column major, same as glUniformMatrix4fv without transpose
+void orthographicProjection(GLfloat out[16],
+	float left, float right,
+	float bottom, float top,
+	float near, float far);
+
+#endif